@@ -0,0 +1,181 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include "CollisionFunctions.h"
+
+/* ------------------------------
+BROADPHASE CLASS
+
+The BroadPhase finds which shapes could be colliding before any are
+passed to CollideShapeToShape, so only nearby pairs pay for the narrow
+phase rather than every shape being tested against every other.
+
+Bounded shapes (squares, circles and shapes with a polygon attached)
+are found with sort and sweep: their bounds are sorted by their minimum
+along one axis, then each is only compared with the shapes that start
+before it ends along that axis.
+The axis is whichever the shapes are most spread along, and the order is
+kept between steps, so as shapes only move a little each step, re-sorting
+them is close to a single pass.
+Planes have no bounds, so each is compared with every bounded shape
+instead, keeping those whose bounds reach behind the plane.
+-------------------------------*/
+
+// Two shapes that could be colliding, to be passed to CollideShapeToShape
+struct ShapePair
+{
+	Shape* shapeA;
+	Shape* shapeB;
+};
+
+// Returns a hash of the specified pair of shapes, the same whichever order they're in, for tables of what's kept per pair
+inline uint64_t GetShapePairHash(const Shape* shapeA, const Shape* shapeB)
+{
+	uintptr_t low = std::min((uintptr_t)shapeA, (uintptr_t)shapeB);
+	uintptr_t high = std::max((uintptr_t)shapeA, (uintptr_t)shapeB);
+	return ((uint64_t)low * 0x9E3779B97F4A7C15ull) ^ ((uint64_t)high * 0xC2B2AE3D27D4EB4Full);
+}
+
+class BroadPhase
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes an empty BroadPhase
+	BroadPhase()
+	{
+		axis = 0;
+	}
+
+	/* ---- SEARCH FUNCTIONS ---- */
+	// Stores every pair of the specified shapes whose bounds overlap, with shapeA being the earlier of the two in the shapes passed
+	void FindPairs(const std::vector<Shape*>& shapes, std::vector<ShapePair>& pairs)
+	{
+		pairs.clear();
+		int shapeCount = (int)shapes.size();
+
+		/* --- BOUNDS --- */
+
+		// Start from the last step's order when there are still the same number of shapes, otherwise from scratch
+		bool isSorted = (int)order.size() == shapeCount;
+		if (!isSorted)
+		{
+			order.resize(shapeCount);
+			std::iota(order.begin(), order.end(), 0);
+		}
+
+		// Store the bounds of each shape in that order, keeping planes aside
+		entries.clear();
+		planes.clear();
+		glm::vec2 centreTotal(0.0f, 0.0f), centreSquareTotal(0.0f, 0.0f);
+		for (int index : order)
+		{
+			Entry entry;
+			entry.index = index;
+			if (!GetShapeBounds(*shapes[index], &entry.min, &entry.max))
+			{
+				planes.push_back(index);
+				continue;
+			}
+			glm::vec2 centre = (entry.min + entry.max) * 0.5f;
+			centreTotal += centre;
+			centreSquareTotal += glm::vec2(centre.x * centre.x, centre.y * centre.y);
+			entries.push_back(entry);
+		}
+
+		// Sweep along the axis the shapes are most spread along, sorting from scratch if it has changed
+		int count = (int)entries.size();
+		if (count > 0)
+		{
+			glm::vec2 mean = centreTotal / (float)count;
+			glm::vec2 variance = centreSquareTotal / (float)count - glm::vec2(mean.x * mean.x, mean.y * mean.y);
+			int newAxis = (variance.y > variance.x) ? 1 : 0;
+			isSorted = isSorted && newAxis == axis;
+			axis = newAxis;
+		}
+		for (Entry& entry : entries)
+		{
+			entry.lower = (axis == 0) ? entry.min.x : entry.min.y;
+			entry.upper = (axis == 0) ? entry.max.x : entry.max.y;
+		}
+
+		/* --- SORT --- */
+
+		// An insertion sort only moves each shape past the few it has overtaken since the last step
+		auto isLower = [](const Entry& a, const Entry& b) { return a.lower < b.lower; };
+		if (isSorted)
+		{
+			for (int i = 1; i < count; i++)
+			{
+				Entry entry = entries[i];
+				int j = i - 1;
+				for (; j >= 0 && isLower(entry, entries[j]); j--)
+					entries[j + 1] = entries[j];
+				entries[j + 1] = entry;
+			}
+		}
+		else
+			std::sort(entries.begin(), entries.end(), isLower);
+
+		// Keep the order for the next step, with the planes at the end
+		for (int i = 0; i < count; i++)
+			order[i] = entries[i].index;
+		std::copy(planes.begin(), planes.end(), order.begin() + count);
+
+		/* --- SWEEP --- */
+
+		// Compare each shape with those starting before it ends, stopping at the first that starts after
+		for (int i = 0; i < count; i++)
+		{
+			const Entry& a = entries[i];
+			for (int j = i + 1; j < count && entries[j].lower <= a.upper; j++)
+			{
+				const Entry& b = entries[j];
+				if (a.max.x < b.min.x || b.max.x < a.min.x || a.max.y < b.min.y || b.max.y < a.min.y)
+					continue;
+				AddPair(shapes, a.index, b.index, pairs);
+			}
+		}
+
+		// Compare each plane with every bounded shape, keeping those whose bounds reach behind it
+		for (int plane : planes)
+		{
+			const Plane& shapePlane = *(Plane*)shapes[plane];
+			for (const Entry& entry : entries)
+			{
+				// The corner of the bounds furthest behind the plane is found from the signs of its normal
+				glm::vec2 corner(
+					(shapePlane.normal.x > 0.0f) ? entry.min.x : entry.max.x,
+					(shapePlane.normal.y > 0.0f) ? entry.min.y : entry.max.y);
+				if (glm::dot(corner, shapePlane.normal) <= shapePlane.offset)
+					AddPair(shapes, plane, entry.index, pairs);
+			}
+		}
+	}
+
+private:
+	// The bounds of a single bounded shape
+	struct Entry
+	{
+		glm::vec2 min;		// The minimum coordinates of the shape's bounds
+		glm::vec2 max;		// The maximum coordinates of the shape's bounds
+		float lower;		// The minimum of the bounds along the sweep axis
+		float upper;		// The maximum of the bounds along the sweep axis
+		int index;			// The index of the shape in the shapes passed
+	};
+
+	// Stores the pair of shapes at the specified indices, earliest first
+	static void AddPair(const std::vector<Shape*>& shapes, int indexA, int indexB, std::vector<ShapePair>& pairs)
+	{
+		if (indexA > indexB)
+			std::swap(indexA, indexB);
+		pairs.push_back({ shapes[indexA], shapes[indexB] });
+	}
+
+	/* ---- VARIABLES ---- */
+	std::vector<Entry> entries;		// The bounds of each bounded shape, sorted along the sweep axis
+	std::vector<int> planes;		// The indices of the planes in the shapes passed
+	std::vector<int> order;			// The order of the shapes after the last step's sort, kept to sort the next step quickly
+	int axis;						// The axis shapes were last swept along (0 for x, 1 for y)
+};
@@ -0,0 +1,231 @@
+#include "CollisionBatch.h"
+#include <algorithm>
+#include <cmath>
+
+// Four pairs are worked out at a time with SSE, which needs SSSE3 to pack the overlapping ones together (enabled by -mssse3, or /arch:AVX on MSVC)
+#if defined(__SSSE3__) || defined(__AVX__)
+#define COLLISION_BATCH_SSE
+#include <tmmintrin.h>
+
+// For each mask of overlapping lanes, the lanes to keep in order, padded with lane 0
+alignas(16) static const int KEPT_LANES[16][4] =
+{
+	{ 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 1, 0, 0, 0 }, { 0, 1, 0, 0 },
+	{ 2, 0, 0, 0 }, { 0, 2, 0, 0 }, { 1, 2, 0, 0 }, { 0, 1, 2, 0 },
+	{ 3, 0, 0, 0 }, { 0, 3, 0, 0 }, { 1, 3, 0, 0 }, { 0, 1, 3, 0 },
+	{ 2, 3, 0, 0 }, { 0, 2, 3, 0 }, { 1, 2, 3, 0 }, { 0, 1, 2, 3 }
+};
+// For each mask of overlapping lanes, the number of lanes to keep
+static const int KEPT_COUNT[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+#endif
+
+// Writes collision information into a ContactBatch, keeping only the pairs that overlap, packed together at the start
+// The arrays are written through plain pointers so the number kept can stay in a register
+struct ContactWriter
+{
+	// Initializes the ContactWriter to write into the specified contacts, which must have room for every pair
+	ContactWriter(ContactBatch& contacts)
+	{
+		pair = contacts.pair.data();
+		depth = contacts.depth.data();
+		normalX = contacts.normalX.data();
+		normalY = contacts.normalY.data();
+		worldPosX = contacts.worldPosX.data();
+		worldPosY = contacts.worldPosY.data();
+		count = 0;
+	}
+
+	// Writes collision information for the pair at the specified index after the last kept, only keeping it if it overlaps
+	// Every pair is written rather than branching on whether it overlaps, which is hard to predict
+	void Add(int index, float depthValue, float normalXValue, float normalYValue, float worldPosXValue, float worldPosYValue)
+	{
+		pair[count] = index;
+		depth[count] = depthValue;
+		normalX[count] = normalXValue;
+		normalY[count] = normalYValue;
+		worldPosX[count] = worldPosXValue;
+		worldPosY[count] = worldPosYValue;
+		count += (depthValue > 0.0f) ? 1 : 0;
+	}
+
+#ifdef COLLISION_BATCH_SSE
+	// Writes collision information for the four pairs from the specified index after the last kept, only keeping those that overlap
+	void Add(int first, __m128 depthValues, __m128 normalXValues, __m128 normalYValues, __m128 worldPosXValues, __m128 worldPosYValues)
+	{
+		// Shuffle the overlapping lanes to the front, building the byte shuffle from the lanes to keep (lane * 4 + byte)
+		int overlapping = _mm_movemask_ps(_mm_cmpgt_ps(depthValues, _mm_setzero_ps()));
+		__m128i lanes = _mm_load_si128((const __m128i*)KEPT_LANES[overlapping]);
+		__m128i bytes = _mm_slli_epi32(lanes, 2);
+		bytes = _mm_or_si128(bytes, _mm_slli_epi32(bytes, 8));
+		bytes = _mm_or_si128(bytes, _mm_slli_epi32(bytes, 16));
+		bytes = _mm_add_epi8(bytes, _mm_set1_epi32(0x03020100));
+
+		_mm_storeu_si128((__m128i*)(pair + count), _mm_add_epi32(lanes, _mm_set1_epi32(first)));
+		_mm_storeu_ps(depth + count, Shuffle(depthValues, bytes));
+		_mm_storeu_ps(normalX + count, Shuffle(normalXValues, bytes));
+		_mm_storeu_ps(normalY + count, Shuffle(normalYValues, bytes));
+		_mm_storeu_ps(worldPosX + count, Shuffle(worldPosXValues, bytes));
+		_mm_storeu_ps(worldPosY + count, Shuffle(worldPosYValues, bytes));
+		count += KEPT_COUNT[overlapping];
+	}
+	static __m128 Shuffle(__m128 values, __m128i bytes) // Returns the specified values with their bytes rearranged
+	{
+		return _mm_castsi128_ps(_mm_shuffle_epi8(_mm_castps_si128(values), bytes));
+	}
+#endif
+
+	int* pair;
+	float* depth;
+	float* normalX;
+	float* normalY;
+	float* worldPosX;
+	float* worldPosY;
+	int count;
+};
+
+// Writes collision information for the pair of Circles at the specified index, matching CollideCircleToCircle.
+static void CollideCircleToCircleAt(const CircleBatch& circlesA, const CircleBatch& circlesB, int i, ContactWriter& contacts)
+{
+	// Get the circles' position difference and magnitude
+	float differenceX = circlesB.positionX[i] - circlesA.positionX[i];
+	float differenceY = circlesB.positionY[i] - circlesA.positionY[i];
+	float distance = std::sqrt(differenceX * differenceX + differenceY * differenceY);
+
+	// Calculate and write collision information
+	float depth = circlesA.radius[i] + circlesB.radius[i] - distance;
+	float normalX = differenceX / distance;
+	float normalY = differenceY / distance;
+	contacts.Add(i, depth, normalX, normalY, circlesB.positionX[i] - normalX, circlesB.positionY[i] - normalY);
+}
+
+// Writes collision information for the Circle and Square at the specified index, matching CollideCircleToSquare.
+static void CollideCircleToSquareAt(const CircleBatch& circles, const SquareBatch& squares, int i, ContactWriter& contacts)
+{
+	// Clamp circle's position to square's bounds
+	float circleX = circles.positionX[i];
+	float circleY = circles.positionY[i];
+	float clampedX = std::min(std::max(circleX, squares.minX[i]), squares.maxX[i]);
+	float clampedY = std::min(std::max(circleY, squares.minY[i]), squares.maxY[i]);
+
+	// Calculate collision information accounting for overlap
+	float differenceX = clampedX - circleX;
+	float differenceY = clampedY - circleY;
+	float distance = std::sqrt(differenceX * differenceX + differenceY * differenceY);
+	float depth, normalX, normalY;
+	if (distance <= 0.0f)
+	{
+		// The circle's centre is inside the square, so push it out along the axis it's furthest along
+		float relativeX = squares.positionX[i] - circleX;
+		float relativeY = squares.positionY[i] - circleY;
+		if (relativeX == relativeY)
+		{
+			depth = std::sqrt(relativeX * relativeX + relativeY * relativeY);
+			normalX = relativeX;
+			normalY = relativeY;
+		}
+		else if (std::abs(relativeX) > std::abs(relativeY))
+		{
+			// Normalized the same way as glm::normalize, by multiplying by the inverse length
+			depth = std::abs(relativeY);
+			normalX = 0.0f * (1.0f / std::sqrt(relativeY * relativeY));
+			normalY = relativeY * (1.0f / std::sqrt(relativeY * relativeY));
+		}
+		else
+		{
+			depth = std::abs(relativeX);
+			normalX = relativeX * (1.0f / std::sqrt(relativeX * relativeX));
+			normalY = 0.0f * (1.0f / std::sqrt(relativeX * relativeX));
+		}
+	}
+	else
+	{
+		depth = circles.radius[i] - distance;
+		normalX = differenceX / distance;
+		normalY = differenceY / distance;
+	}
+
+	contacts.Add(i, depth, normalX, normalY, clampedX, clampedY);
+}
+
+// Stores collision information for each overlapping pair of Circles at the same index of the two batches, replacing the contacts' contents.
+void CollideCirclesToCircles(const CircleBatch& circlesA, const CircleBatch& circlesB, ContactBatch& contacts)
+{
+	int count = std::min(circlesA.GetCount(), circlesB.GetCount());
+	contacts.Reserve(count);
+	ContactWriter writer(contacts);
+	int i = 0;
+
+#ifdef COLLISION_BATCH_SSE
+	const float* positionAX = circlesA.positionX.data();
+	const float* positionAY = circlesA.positionY.data();
+	const float* positionBX = circlesB.positionX.data();
+	const float* positionBY = circlesB.positionY.data();
+	const float* radiusA = circlesA.radius.data();
+	const float* radiusB = circlesB.radius.data();
+	for (; i + 4 <= count; i += 4)
+	{
+		// Get the circles' position difference and magnitude
+		__m128 circleBX = _mm_loadu_ps(positionBX + i);
+		__m128 circleBY = _mm_loadu_ps(positionBY + i);
+		__m128 differenceX = _mm_sub_ps(circleBX, _mm_loadu_ps(positionAX + i));
+		__m128 differenceY = _mm_sub_ps(circleBY, _mm_loadu_ps(positionAY + i));
+		__m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(differenceX, differenceX), _mm_mul_ps(differenceY, differenceY)));
+
+		// Calculate and write collision information
+		__m128 depth = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(radiusA + i), _mm_loadu_ps(radiusB + i)), distance);
+		__m128 normalX = _mm_div_ps(differenceX, distance);
+		__m128 normalY = _mm_div_ps(differenceY, distance);
+		writer.Add(i, depth, normalX, normalY, _mm_sub_ps(circleBX, normalX), _mm_sub_ps(circleBY, normalY));
+	}
+#endif
+
+	for (; i < count; i++)
+		CollideCircleToCircleAt(circlesA, circlesB, i, writer);
+	contacts.count = writer.count;
+}
+
+// Stores collision information for each overlapping Circle and Square at the same index of the two batches, replacing the contacts' contents.
+void CollideCirclesToSquares(const CircleBatch& circles, const SquareBatch& squares, ContactBatch& contacts)
+{
+	int count = std::min(circles.GetCount(), squares.GetCount());
+	contacts.Reserve(count);
+	ContactWriter writer(contacts);
+	int i = 0;
+
+#ifdef COLLISION_BATCH_SSE
+	const float* positionX = circles.positionX.data();
+	const float* positionY = circles.positionY.data();
+	const float* radius = circles.radius.data();
+	const float* minX = squares.minX.data();
+	const float* minY = squares.minY.data();
+	const float* maxX = squares.maxX.data();
+	const float* maxY = squares.maxY.data();
+	for (; i + 4 <= count; i += 4)
+	{
+		// Clamp circles' positions to squares' bounds
+		__m128 circleX = _mm_loadu_ps(positionX + i);
+		__m128 circleY = _mm_loadu_ps(positionY + i);
+		__m128 clampedX = _mm_min_ps(_mm_max_ps(circleX, _mm_loadu_ps(minX + i)), _mm_loadu_ps(maxX + i));
+		__m128 clampedY = _mm_min_ps(_mm_max_ps(circleY, _mm_loadu_ps(minY + i)), _mm_loadu_ps(maxY + i));
+		__m128 differenceX = _mm_sub_ps(clampedX, circleX);
+		__m128 differenceY = _mm_sub_ps(clampedY, circleY);
+		__m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(differenceX, differenceX), _mm_mul_ps(differenceY, differenceY)));
+
+		// Circles whose centres are inside their squares are rare, so groups with any are left to the single pair version
+		if (_mm_movemask_ps(_mm_cmple_ps(distance, _mm_setzero_ps())) != 0)
+		{
+			for (int lane = 0; lane < 4; lane++)
+				CollideCircleToSquareAt(circles, squares, i + lane, writer);
+			continue;
+		}
+
+		// Calculate and write collision information
+		__m128 depth = _mm_sub_ps(_mm_loadu_ps(radius + i), distance);
+		writer.Add(i, depth, _mm_div_ps(differenceX, distance), _mm_div_ps(differenceY, distance), clampedX, clampedY);
+	}
+#endif
+
+	for (; i < count; i++)
+		CollideCircleToSquareAt(circles, squares, i, writer);
+	contacts.count = writer.count;
+}
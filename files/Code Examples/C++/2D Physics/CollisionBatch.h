@@ -0,0 +1,134 @@
+#pragma once
+#include <vector>
+#include "CollisionFunctions.h"
+
+/* ------------------------------
+COLLISION BATCHES
+
+Batched versions of CollideCircleToCircle and CollideCircleToSquare,
+for running the narrow phase over many candidate pairs at once.
+Shapes are copied into batches holding one array per value (structure
+of arrays), where the shapes at the same index of two batches form a
+pair. Pairs are then processed four at a time with SSE when built with
+SSSE3 (-mssse3, or /arch:AVX on MSVC), falling back to one at a time
+otherwise and for the few left over.
+
+Every pair is worked out, then only those that overlap are kept, packed
+together at the start of a ContactBatch with the index of each pair, so
+the caller only has to go through the collisions that need resolving.
+The results match those of the single-pair functions exactly.
+-------------------------------*/
+
+// Circles stored one array per value, for batched collision
+struct CircleBatch
+{
+	// Adds the specified circle to the end of the batch
+	void Add(const Circle& circle)
+	{
+		positionX.push_back(circle.position.x);
+		positionY.push_back(circle.position.y);
+		radius.push_back(circle.radius);
+	}
+	void Clear() // Empties the batch, keeping its arrays to be filled again
+	{
+		positionX.clear();
+		positionY.clear();
+		radius.clear();
+	}
+	int GetCount() const // Returns the number of circles in the batch
+	{
+		return (int)radius.size();
+	}
+
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> radius;
+};
+
+// Squares stored one array per value, for batched collision
+struct SquareBatch
+{
+	// Adds the specified square to the end of the batch
+	void Add(const Square& square)
+	{
+		glm::vec2 squareMin, squareMax;
+		square.GetCoordinates(&squareMin, &squareMax);
+		positionX.push_back(square.position.x);
+		positionY.push_back(square.position.y);
+		minX.push_back(squareMin.x);
+		minY.push_back(squareMin.y);
+		maxX.push_back(squareMax.x);
+		maxY.push_back(squareMax.y);
+	}
+	void Clear() // Empties the batch, keeping its arrays to be filled again
+	{
+		positionX.clear();
+		positionY.clear();
+		minX.clear();
+		minY.clear();
+		maxX.clear();
+		maxY.clear();
+	}
+	int GetCount() const // Returns the number of squares in the batch
+	{
+		return (int)positionX.size();
+	}
+
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+};
+
+// The collision information of each overlapping pair in a batch, packed together in the order of the pairs
+// The arrays have room for every pair while they're worked out, and are only ever grown, so may be longer than the number of contacts
+struct ContactBatch
+{
+	void Clear() // Empties the batch, keeping its arrays to be filled again
+	{
+		count = 0;
+	}
+	// Grows the arrays to hold at least the specified number of contacts
+	void Reserve(int capacity)
+	{
+		if ((int)pair.size() >= capacity)
+			return;
+		pair.resize(capacity);
+		depth.resize(capacity);
+		normalX.resize(capacity);
+		normalY.resize(capacity);
+		worldPosX.resize(capacity);
+		worldPosY.resize(capacity);
+	}
+	int GetCount() const // Returns the number of overlapping pairs in the batch
+	{
+		return count;
+	}
+	// Returns the collision information at the specified index as CollisionData, between the specified shapes
+	CollisionData GetCollision(int index, Shape* shapeA, Shape* shapeB) const
+	{
+		CollisionData result;
+		result.depth = depth[index];
+		result.normal = glm::vec2(normalX[index], normalY[index]);
+		result.worldPos = glm::vec2(worldPosX[index], worldPosY[index]);
+		result.shapeA = shapeA;
+		result.shapeB = shapeB;
+		return result;
+	}
+
+	int count = 0;						// The number of overlapping pairs in the batch
+	std::vector<int> pair;				// The index of the pair in the batches passed
+	std::vector<float> depth;
+	std::vector<float> normalX;
+	std::vector<float> normalY;
+	std::vector<float> worldPosX;
+	std::vector<float> worldPosY;
+};
+
+// Stores collision information for each overlapping pair of Circles at the same index of the two batches, replacing the contacts' contents.
+void CollideCirclesToCircles(const CircleBatch& circlesA, const CircleBatch& circlesB, ContactBatch& contacts);
+
+// Stores collision information for each overlapping Circle and Square at the same index of the two batches, replacing the contacts' contents.
+void CollideCirclesToSquares(const CircleBatch& circles, const SquareBatch& squares, ContactBatch& contacts);
@@ -1,46 +1,93 @@
 #include "CollisionFunctions.h"
+#include "ShapeTypeIndex.h"
 #include <algorithm>
 
-// Calls the correct function according to the type of shape passed.
-CollisionData CollideShapeToShape(const Shape& shapeA, const Shape& shapeB)
+// The signature shared by every entry of the collision function table
+typedef CollisionData(*ShapeCollideFunction)(const Shape&, const Shape&);
+
+// Casts the shapes passed to their types and calls the collision function for them, so each can sit in the table.
+template<typename TypeA, typename TypeB, CollisionData(*Function)(const TypeA&, const TypeB&)>
+static CollisionData CollideAs(const Shape& shapeA, const Shape& shapeB)
 {
-	// Square and...
-	if (shapeA.GetType() == ShapeType::Square)
-	{
-		if (shapeB.GetType() == ShapeType::Square)
-			return CollideSquareToSquare((Square&)shapeA, (Square&)shapeB);
+	return Function((const TypeA&)shapeA, (const TypeB&)shapeB);
+}
 
-		else if (shapeB.GetType() == ShapeType::Circle)
-			return CollideSquareToCircle((Square&)shapeA, (Circle&)shapeB);
+// Casts the shapes passed to their types and calls the collision function for them in the opposite order.
+template<typename TypeA, typename TypeB, CollisionData(*Function)(const TypeB&, const TypeA&)>
+static CollisionData CollideSwappedAs(const Shape& shapeA, const Shape& shapeB)
+{
+	return Function((const TypeB&)shapeB, (const TypeA&)shapeA);
+}
 
-		else if (shapeB.GetType() == ShapeType::Plane)
-			return CollideSquareToPlane((Square&)shapeA, (Plane&)shapeB);
-	}
+// Calls the collision function for the polygon attached to shape A and shape B cast to its type, so each can sit in the table.
+template<typename TypeB, CollisionData(*Function)(const ConvexPolygon&, const TypeB&)>
+static CollisionData CollidePolygonAs(const Shape& shapeA, const Shape& shapeB)
+{
+	return Function(*GetShapePolygon(&shapeA), (const TypeB&)shapeB);
+}
 
-	// Circle and...
-	else if (shapeA.GetType() == ShapeType::Circle)
-	{
-		if (shapeB.GetType() == ShapeType::Square)
-			return CollideCircleToSquare((Circle&)shapeA, (Square&)shapeB);
+// Calls the collision function for the polygon attached to shape B and shape A cast to its type, in the opposite order.
+template<typename TypeA, CollisionData(*Function)(const ConvexPolygon&, const TypeA&)>
+static CollisionData CollideSwappedPolygonAs(const Shape& shapeA, const Shape& shapeB)
+{
+	return Function(*GetShapePolygon(&shapeB), (const TypeA&)shapeA);
+}
 
-		else if (shapeB.GetType() == ShapeType::Circle)
-			return CollideCircleToCircle((Circle&)shapeA, (Circle&)shapeB);
+// Calls the collision function for the polygons attached to both shapes.
+// Nothing is kept between calls here, so there's no last separating edge to try first; the PairCollider keeps one for each pair.
+static CollisionData CollidePolygons(const Shape& shapeA, const Shape& shapeB)
+{
+	return CollidePolygonToPolygon(*GetShapePolygon(&shapeA), *GetShapePolygon(&shapeB));
+}
 
-		else if (shapeB.GetType() == ShapeType::Plane)
-			return CollideCircleToPlane((Circle&)shapeA, (Plane&)shapeB);
-	}
+// Return empty collision information for shapes that can't collide (two planes).
+static CollisionData CollideNothing(const Shape&, const Shape&)
+{
+	return CollisionData();
+}
 
+// The collision function for each pair of shape types, indexed by GetShapeIndex of shape A then shape B
+static const ShapeCollideFunction COLLIDE_FUNCTIONS[SHAPE_TYPE_COUNT][SHAPE_TYPE_COUNT] =
+{
+	// Square and...
+	{
+		CollideAs<Square, Square, CollideSquareToSquare>,
+		CollideAs<Square, Circle, CollideSquareToCircle>,
+		CollideAs<Square, Plane, CollideSquareToPlane>,
+		CollideSwappedPolygonAs<Square, CollidePolygonToSquare>
+	},
+	// Circle and...
+	{
+		CollideAs<Circle, Square, CollideCircleToSquare>,
+		CollideAs<Circle, Circle, CollideCircleToCircle>,
+		CollideAs<Circle, Plane, CollideCircleToPlane>,
+		CollideSwappedPolygonAs<Circle, CollidePolygonToCircle>
+	},
 	// Plane and...
-	else if (shapeA.GetType() == ShapeType::Plane)
 	{
-		if (shapeB.GetType() == ShapeType::Square)
-			return CollideSquareToPlane((Square&)shapeB, (Plane&)shapeA);
-
-		else if (shapeB.GetType() == ShapeType::Circle)
-			return CollideCircleToPlane((Circle&)shapeB, (Plane&)shapeA);
+		CollideSwappedAs<Plane, Square, CollideSquareToPlane>,
+		CollideSwappedAs<Plane, Circle, CollideCircleToPlane>,
+		CollideNothing,
+		CollideSwappedPolygonAs<Plane, CollidePolygonToPlane>
+	},
+	// Polygon and...
+	{
+		CollidePolygonAs<Square, CollidePolygonToSquare>,
+		CollidePolygonAs<Circle, CollidePolygonToCircle>,
+		CollidePolygonAs<Plane, CollidePolygonToPlane>,
+		CollidePolygons
 	}
+};
 
-	return CollisionData();
+// Calls the correct function according to the type of shape passed, looked up in a table rather than branching on each type.
+CollisionData CollideShapeToShape(const Shape& shapeA, const Shape& shapeB)
+{
+	int indexA = GetShapeIndex(shapeA);
+	int indexB = GetShapeIndex(shapeB);
+	if (indexA == -1 || indexB == -1)
+		return CollisionData();
+
+	return COLLIDE_FUNCTIONS[indexA][indexB](shapeA, shapeB);
 }
 
 // Return collision information for two potentially-colliding Squares.
@@ -204,4 +251,31 @@ CollisionData CollideCircleToPlane(const Circle& circle, const Plane& plane)
 	result.shapeA = (Shape*)&circle;
 	result.shapeB = (Shape*)&plane;
 	return result;
-}
\ No newline at end of file
+}
+
+// Stores the axis-aligned bounds of the shape passed, returning false if it has none (planes are unbounded).
+bool GetShapeBounds(const Shape& shape, glm::vec2* min, glm::vec2* max)
+{
+	// A shape with a polygon attached is bounded by the polygon, which reaches past the shape's own bounds once rotated
+	const ConvexPolygon* polygon = GetShapePolygon(&shape);
+	if (polygon != nullptr)
+	{
+		*min = polygon->GetMinCoordinates();
+		*max = polygon->GetMaxCoordinates();
+		return true;
+	}
+	else if (shape.GetType() == ShapeType::Square)
+	{
+		((Square&)shape).GetCoordinates(min, max);
+		return true;
+	}
+	else if (shape.GetType() == ShapeType::Circle)
+	{
+		const Circle& circle = (Circle&)shape;
+		*min = circle.position - glm::vec2(circle.radius, circle.radius);
+		*max = circle.position + glm::vec2(circle.radius, circle.radius);
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,222 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "BroadPhase.h"
+#include "PolygonCollision.h"
+
+/* ------------------------------
+CONTACTCACHE CLASS
+
+The ContactCache keeps the contact between each pair of shapes from one
+step to the next, so a solver can carry over what it learnt last step.
+Each contact holds the impulse the solver has built up along its normal,
+which is kept while the pair stays in contact so the solver can start
+from it (warm starting) rather than from nothing, needing fewer
+iterations to settle stacks.
+
+A contact is only worked out in full again once either shape has moved
+further than a tolerance from where it was when it was last worked out,
+or has rotated at all (only shapes with a polygon attached can rotate).
+Until then its depth and position are moved along with the shapes
+instead, which holds for small movements as the normal barely changes.
+Where a collision function jumps between normals (a circle's centre
+inside a square), a moved contact keeps its old normal until then.
+Circles and squares are quick to collide, so this mostly pays off for
+costlier shapes; a tolerance of 0 always works contacts out in full.
+
+Contacts are dropped once their pair stops overlapping, or is no longer
+passed in. Each step's contacts are copied into a second list as they're
+found, then found again through an open addressing table of that list.
+-------------------------------*/
+
+// The contact between two shapes, kept from step to step
+struct CachedContact
+{
+	CollisionData collision;		// The collision information for this step
+	float normalImpulse;			// The impulse built up along the normal by the solver, kept for the next step to start from
+
+	CollisionData computed;			// The collision information when it was last worked out in full
+	glm::vec2 computedPositionA;	// The position of the computed collision's shape A when it was worked out
+	glm::vec2 computedPositionB;	// The position of the computed collision's shape B when it was worked out
+	float computedRotationA;		// The rotation of the computed collision's shape A when it was worked out
+	float computedRotationB;		// The rotation of the computed collision's shape B when it was worked out
+};
+
+class ContactCache
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes an empty ContactCache, working contacts out in full once a shape moves further than the specified distance
+	ContactCache(float tolerance = DEFAULT_TOLERANCE)
+	{
+		this->tolerance = tolerance;
+		current = 0;
+		reusedCount = 0;
+		BuildTable();
+	}
+
+	/* ---- UPDATE FUNCTIONS ---- */
+	// Collides each of the specified pairs, storing the contact of each that overlaps, and drops contacts that no longer overlap or weren't passed
+	// The contacts stay valid until the next call to Update or Clear
+	void Update(const std::vector<ShapePair>& pairs, std::vector<CachedContact*>& contacts)
+	{
+		// Contacts found this step are copied from last step's into the other list, so those not found are simply left behind
+		const std::vector<CachedContact>& last = stored[current];
+		std::vector<CachedContact>& next = stored[1 - current];
+		next.clear();
+		next.reserve(pairs.size());
+		reusedCount = 0;
+
+		for (const ShapePair& pair : pairs)
+		{
+			int index = Find(pair);
+			if (index != -1)
+			{
+				// Reuse the last computed collision if neither shape has moved far, otherwise work it out again
+				CachedContact contact = last[index];
+				if (Reuse(contact))
+					reusedCount++;
+				else
+					Compute(pair, contact);
+				if (contact.collision.depth > 0.0f)
+					next.push_back(contact);
+			}
+			else
+			{
+				CollisionData collision = CollideShapeToShape(*pair.shapeA, *pair.shapeB);
+				if (collision.depth <= 0.0f)
+					continue;
+
+				CachedContact contact;
+				contact.normalImpulse = 0.0f;
+				Store(collision, contact);
+				next.push_back(contact);
+			}
+		}
+
+		current = 1 - current;
+		BuildTable();
+		contacts.clear();
+		for (CachedContact& contact : next)
+			contacts.push_back(&contact);
+	}
+	void Clear() // Drops every contact, so every pair is worked out in full and starts with no impulse
+	{
+		stored[current].clear();
+		BuildTable();
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	int GetContactCount() const // Returns the number of contacts kept
+	{
+		return (int)stored[current].size();
+	}
+	int GetReusedCount() const // Returns the number of pairs moved along rather than worked out in full by the last call to Update
+	{
+		return reusedCount;
+	}
+
+	/* ---- CONSTANTS ---- */
+	static constexpr float DEFAULT_TOLERANCE = 0.01f;		// The default distance a shape can move before its contacts are worked out in full
+	static constexpr float NORMAL_MATCH = 0.95f;			// The least dot product between the old and new normal for the impulse to be kept
+
+private:
+	// Returns the slot of the table a pair of shapes is looked for from, the same whichever order they're in
+	size_t GetSlot(const Shape* shapeA, const Shape* shapeB) const
+	{
+		return (size_t)(GetShapePairHash(shapeA, shapeB) >> 32) & (table.size() - 1);
+	}
+	// Returns the index of the specified pair's contact from last step, or -1 if it had none
+	int Find(const ShapePair& pair) const
+	{
+		// Look through the slots from the pair's own until an empty one
+		const std::vector<CachedContact>& last = stored[current];
+		for (size_t slot = GetSlot(pair.shapeA, pair.shapeB);; slot = (slot + 1) & (table.size() - 1))
+		{
+			int index = table[slot];
+			if (index == -1)
+				return -1;
+
+			const CollisionData& collision = last[index].computed;
+			if ((collision.shapeA == pair.shapeA && collision.shapeB == pair.shapeB) || (collision.shapeA == pair.shapeB && collision.shapeB == pair.shapeA))
+				return index;
+		}
+	}
+	// Rebuilds the table of slots from the current contacts, at least twice as big as the number of contacts so it's never full
+	void BuildTable()
+	{
+		const std::vector<CachedContact>& contacts = stored[current];
+		size_t size = 16;
+		while (size < contacts.size() * 2)
+			size *= 2;
+		table.assign(size, -1);
+
+		for (int index = 0; index < (int)contacts.size(); index++)
+		{
+			size_t slot = GetSlot(contacts[index].computed.shapeA, contacts[index].computed.shapeB);
+			while (table[slot] != -1)
+				slot = (slot + 1) & (size - 1);
+			table[slot] = index;
+		}
+	}
+
+	// Returns the position of the specified shape, as far as contacts are concerned (planes never move, and polygons move their shapes)
+	static glm::vec2 GetPosition(const Shape* shape)
+	{
+		const ConvexPolygon* polygon = GetShapePolygon(shape);
+		if (polygon != nullptr)
+			return polygon->GetPosition();
+		return (shape->GetType() == ShapeType::Plane) ? glm::vec2(0.0f, 0.0f) : shape->position;
+	}
+	// Returns the rotation of the specified shape, which is its polygon's if it has one (other shapes never rotate)
+	static float GetRotation(const Shape* shape)
+	{
+		const ConvexPolygon* polygon = GetShapePolygon(shape);
+		return (polygon != nullptr) ? polygon->GetRotation() : 0.0f;
+	}
+	// Works out the collision of the specified pair in full, keeping the contact's impulse if its normal is much the same
+	static void Compute(const ShapePair& pair, CachedContact& contact)
+	{
+		CollisionData collision = CollideShapeToShape(*pair.shapeA, *pair.shapeB);
+		if (glm::dot(collision.normal, contact.computed.normal) < NORMAL_MATCH)
+			contact.normalImpulse = 0.0f;
+		Store(collision, contact);
+	}
+	// Stores the specified collision as the contact's, along with where its shapes are
+	static void Store(const CollisionData& collision, CachedContact& contact)
+	{
+		contact.collision = collision;
+		contact.computed = collision;
+		contact.computedPositionA = GetPosition(collision.shapeA);
+		contact.computedPositionB = GetPosition(collision.shapeB);
+		contact.computedRotationA = GetRotation(collision.shapeA);
+		contact.computedRotationB = GetRotation(collision.shapeB);
+	}
+	// Moves the contact's computed collision along with its shapes, returning false without changing it if either has moved too far or rotated
+	bool Reuse(CachedContact& contact) const
+	{
+		// Rotating changes the normal and can move the contact to another corner, so it can't be moved along
+		const CollisionData& computed = contact.computed;
+		if (GetRotation(computed.shapeA) != contact.computedRotationA || GetRotation(computed.shapeB) != contact.computedRotationB)
+			return false;
+
+		glm::vec2 movementA = GetPosition(computed.shapeA) - contact.computedPositionA;
+		glm::vec2 movementB = GetPosition(computed.shapeB) - contact.computedPositionB;
+		if (glm::dot(movementA, movementA) > tolerance * tolerance || glm::dot(movementB, movementB) > tolerance * tolerance)
+			return false;
+
+		// The normal points from shape A to shape B, so shape B moving along it makes the shapes overlap less
+		contact.collision = computed;
+		contact.collision.depth = computed.depth - glm::dot(movementB - movementA, computed.normal);
+		contact.collision.worldPos = computed.worldPos + (movementA + movementB) * 0.5f;
+		return true;
+	}
+
+	/* ---- VARIABLES ---- */
+	std::vector<CachedContact> stored[2];		// The contacts found last step, and those being found this step, swapping each step
+	std::vector<int> table;						// The index of a contact from last step in each slot, or -1 if empty (open addressing)
+	int current;								// Which of the stored lists holds the contacts found last step
+	float tolerance;							// The distance a shape can move before its contacts are worked out in full
+	int reusedCount;							// The number of pairs moved along rather than worked out by the last call to Update
+};
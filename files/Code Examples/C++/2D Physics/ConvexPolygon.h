@@ -0,0 +1,145 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "CollisionFunctions.h"
+
+/* ------------------------------
+CONVEXPOLYGON CLASS
+
+A ConvexPolygon is the outline of a shape that can be rotated, such as a
+rotated crate, for the collision functions in PolygonCollision.h.
+Its vertices are set once around its own centre (anticlockwise), then
+each step it's moved and rotated with SetTransform, which works out its
+vertices, edge normals and bounds in the world, so every pair it's
+collided with that step can share them.
+
+A polygon set with SetBox that isn't rotated is marked as axis aligned,
+so collisions between two of them (and with planes) can take the same
+shortcuts as squares. It keeps the shape it belongs to, which is what
+its collisions are stored against.
+-------------------------------*/
+
+class ConvexPolygon
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes an empty ConvexPolygon belonging to the specified shape
+	ConvexPolygon(Shape* shape = nullptr)
+	{
+		this->shape = shape;
+		position = glm::vec2(0.0f, 0.0f);
+		rotation = 0.0f;
+		isBox = false;
+		isAxisAligned = false;
+	}
+
+	/* ---- SETTER FUNCTIONS ---- */
+	// Sets the polygon to a box with the specified half extents, at its current position and rotation
+	void SetBox(glm::vec2 extents)
+	{
+		SetVertices({
+			glm::vec2(-extents.x, -extents.y),
+			glm::vec2(extents.x, -extents.y),
+			glm::vec2(extents.x, extents.y),
+			glm::vec2(-extents.x, extents.y) });
+		isBox = true;
+		isAxisAligned = rotation == 0.0f;
+	}
+	// Sets the vertices of the polygon around its centre, which must be convex and in anticlockwise order
+	void SetVertices(const std::vector<glm::vec2>& vertices)
+	{
+		localVertices = vertices;
+		localNormals.resize(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			// The outward normal of the edge from this vertex to the next
+			glm::vec2 edge = vertices[(i + 1) % vertices.size()] - vertices[i];
+			localNormals[i] = glm::normalize(glm::vec2(edge.y, -edge.x));
+		}
+
+		isBox = false;
+		isAxisAligned = false;
+		SetTransform(position, rotation);
+	}
+	// Moves the polygon to the specified position and rotation (in radians, anticlockwise), working out its vertices in the world
+	void SetTransform(glm::vec2 position, float rotation)
+	{
+		this->position = position;
+		this->rotation = rotation;
+		isAxisAligned = isBox && rotation == 0.0f;
+
+		float cosine = std::cos(rotation);
+		float sine = std::sin(rotation);
+		int count = GetVertexCount();
+		vertices.resize(count);
+		normals.resize(count);
+		for (int i = 0; i < count; i++)
+		{
+			glm::vec2 vertex = localVertices[i];
+			glm::vec2 normal = localNormals[i];
+			vertices[i] = position + glm::vec2(cosine * vertex.x - sine * vertex.y, sine * vertex.x + cosine * vertex.y);
+			normals[i] = glm::vec2(cosine * normal.x - sine * normal.y, sine * normal.x + cosine * normal.y);
+		}
+
+		// Store the bounds of the vertices
+		minCoordinates = maxCoordinates = (count > 0) ? vertices[0] : position;
+		for (const glm::vec2& vertex : vertices)
+		{
+			minCoordinates = glm::vec2(std::min(minCoordinates.x, vertex.x), std::min(minCoordinates.y, vertex.y));
+			maxCoordinates = glm::vec2(std::max(maxCoordinates.x, vertex.x), std::max(maxCoordinates.y, vertex.y));
+		}
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	Shape* GetShape() const // Returns the shape the polygon belongs to, which its collisions are stored against
+	{
+		return shape;
+	}
+	int GetVertexCount() const // Returns the number of vertices (and edges) of the polygon
+	{
+		return (int)localVertices.size();
+	}
+	const glm::vec2& GetVertex(int index) const // Returns the position of the vertex at the specified index in the world
+	{
+		return vertices[index];
+	}
+	const glm::vec2& GetNormal(int index) const // Returns the outward normal of the edge from the vertex at the specified index to the next, in the world
+	{
+		return normals[index];
+	}
+	glm::vec2 GetPosition() const // Returns the position of the polygon's centre
+	{
+		return position;
+	}
+	float GetRotation() const // Returns the rotation of the polygon in radians
+	{
+		return rotation;
+	}
+	glm::vec2 GetMinCoordinates() const // Returns the minimum coordinates of the polygon's bounds
+	{
+		return minCoordinates;
+	}
+	glm::vec2 GetMaxCoordinates() const // Returns the maximum coordinates of the polygon's bounds
+	{
+		return maxCoordinates;
+	}
+	bool IsAxisAligned() const // Returns whether the polygon is an unrotated box, so its bounds are its outline
+	{
+		return isAxisAligned;
+	}
+
+private:
+	/* ---- VARIABLES ---- */
+	Shape* shape;							// The shape the polygon belongs to
+	std::vector<glm::vec2> localVertices;	// The vertices around the polygon's centre, anticlockwise
+	std::vector<glm::vec2> localNormals;	// The outward normal of each edge, before rotation
+	std::vector<glm::vec2> vertices;		// The vertices in the world
+	std::vector<glm::vec2> normals;			// The outward normal of each edge in the world
+	glm::vec2 position;						// The position of the polygon's centre
+	float rotation;							// The rotation of the polygon in radians, anticlockwise
+	glm::vec2 minCoordinates;				// The minimum coordinates of the polygon's bounds
+	glm::vec2 maxCoordinates;				// The maximum coordinates of the polygon's bounds
+	bool isBox;								// Whether the polygon was set with SetBox
+	bool isAxisAligned;						// Whether the polygon is a box that isn't rotated
+};
@@ -0,0 +1,412 @@
+#pragma once
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <vector>
+#include "CollisionFunctions.h"
+
+/* ------------------------------
+DYNAMICTREE CLASS
+
+The DynamicTree is a bounding volume hierarchy over bounded shapes
+(squares, circles and shapes with a polygon attached), kept up to date
+as shapes are added, moved and removed rather than rebuilt each step.
+Each shape is stored in a leaf, known as its proxy, with its bounds
+grown by a margin on every side. Moving (or rotating) a shape costs
+nothing until its bounds leave that fattened box, when its leaf is taken
+out and inserted again; in a mostly-still scene, hardly any leaves
+change each step.
+
+Leaves are inserted beside whichever node grows the tree's total
+perimeter the least, and the tree is rebalanced with rotations on the
+way back up, so queries stay logarithmic however shapes are added.
+The tree can be queried for the shapes in a region, behind a plane, or
+along a ray. Each query calls back with the shapes whose fattened boxes
+pass, leaving the exact test to the caller.
+-------------------------------*/
+
+class DynamicTree
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes an empty DynamicTree, fattening the bounds of each shape by the specified margin
+	DynamicTree(float margin = DEFAULT_MARGIN) : margin(margin)
+	{
+		root = -1;
+		freeList = -1;
+	}
+
+	/* ---- PROXY FUNCTIONS ---- */
+	// Adds the specified shape to the tree, returning its proxy ID, or -1 if it has no bounds (such as a plane)
+	int CreateProxy(Shape* shape)
+	{
+		glm::vec2 min, max;
+		if (!GetShapeBounds(*shape, &min, &max))
+			return -1;
+
+		int proxy = AllocateNode();
+		nodes[proxy].min = min - glm::vec2(margin, margin);
+		nodes[proxy].max = max + glm::vec2(margin, margin);
+		nodes[proxy].shape = shape;
+		nodes[proxy].height = 0;
+		InsertLeaf(proxy);
+		return proxy;
+	}
+	// Removes the proxy with the specified ID from the tree
+	void DestroyProxy(int proxy)
+	{
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+	}
+	// Updates the proxy with the specified ID to its shape's current bounds, returning true if it was reinserted
+	// Returns false, doing nothing, while the shape's bounds are still inside its fattened box
+	bool MoveProxy(int proxy)
+	{
+		Node& node = nodes[proxy];
+		glm::vec2 min, max;
+		GetShapeBounds(*node.shape, &min, &max);
+		if (node.min.x <= min.x && node.min.y <= min.y && max.x <= node.max.x && max.y <= node.max.y)
+			return false;
+
+		RemoveLeaf(proxy);
+		node.min = min - glm::vec2(margin, margin);
+		node.max = max + glm::vec2(margin, margin);
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	/* ---- QUERY FUNCTIONS ---- */
+	// Calls the specified function with the shape and proxy ID of every proxy whose fattened box overlaps the specified region
+	// The function returns false to stop the query early
+	template<typename Function>
+	void Query(glm::vec2 min, glm::vec2 max, Function callback) const
+	{
+		Traverse([&](const Node& node) { return IsOverlapping(node, min, max); }, callback);
+	}
+	// Calls the specified function with the shape and proxy ID of every proxy whose fattened box reaches behind the specified plane
+	// The function returns false to stop the query early
+	template<typename Function>
+	void QueryPlane(const Plane& plane, Function callback) const
+	{
+		Traverse([&](const Node& node)
+		{
+			// The corner of the box furthest behind the plane is found from the signs of its normal
+			glm::vec2 corner(
+				(plane.normal.x > 0.0f) ? node.min.x : node.max.x,
+				(plane.normal.y > 0.0f) ? node.min.y : node.max.y);
+			return glm::dot(corner, plane.normal) <= plane.offset;
+		}, callback);
+	}
+	// Calls the specified function with the shape and proxy ID of every proxy whose fattened box the specified ray passes through
+	// The direction must be normalized, and the function returns the distance to shorten the ray to (its hit), or 0 to stop
+	template<typename Function>
+	void RayCast(glm::vec2 origin, glm::vec2 direction, float maxDistance, Function callback) const
+	{
+		// Boxes are tested against the ray with the slab method, using the inverse direction so axis-aligned rays divide by zero safely
+		glm::vec2 inverse(1.0f / direction.x, 1.0f / direction.y);
+		auto isHit = [&](const Node& node)
+		{
+			float nearest = 0.0f;
+			float furthest = maxDistance;
+			for (int axis = 0; axis < 2; axis++)
+			{
+				float start = (axis == 0) ? origin.x : origin.y;
+				float lower = (axis == 0) ? node.min.x : node.min.y;
+				float upper = (axis == 0) ? node.max.x : node.max.y;
+				float step = (axis == 0) ? inverse.x : inverse.y;
+				if (std::isinf(step))
+				{
+					// A ray parallel to this axis only hits if it starts between the box's sides
+					if (start < lower || start > upper)
+						return false;
+					continue;
+				}
+				float distanceA = (lower - start) * step;
+				float distanceB = (upper - start) * step;
+				nearest = std::max(nearest, std::min(distanceA, distanceB));
+				furthest = std::min(furthest, std::max(distanceA, distanceB));
+			}
+			return nearest <= furthest;
+		};
+		Traverse(isHit, [&](Shape* shape, int proxy)
+		{
+			maxDistance = callback(shape, proxy);
+			return maxDistance > 0.0f;
+		});
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	// Stores the minimum and maximum coordinates of the fattened box of the proxy with the specified ID
+	void GetFatBounds(int proxy, glm::vec2* min, glm::vec2* max) const
+	{
+		*min = nodes[proxy].min;
+		*max = nodes[proxy].max;
+	}
+	Shape* GetShape(int proxy) const // Returns the shape stored in the proxy with the specified ID
+	{
+		return nodes[proxy].shape;
+	}
+	int GetHeight() const // Returns the height of the tree, where a tree of a single leaf has a height of 0
+	{
+		return (root == -1) ? 0 : nodes[root].height;
+	}
+
+	/* ---- CONSTANTS ---- */
+	static constexpr float DEFAULT_MARGIN = 2.0f;		// The default distance the bounds of each shape are grown by on every side
+	static const int MAX_STACK = 256;					// The most nodes a query can have waiting to be visited
+
+private:
+	// A single node, which is either a leaf holding a shape or a branch with two children
+	struct Node
+	{
+		glm::vec2 min;			// The minimum coordinates of the node's box (fattened, for leaves)
+		glm::vec2 max;			// The maximum coordinates of the node's box (fattened, for leaves)
+		Shape* shape;			// The shape held by a leaf, or nullptr for branches
+		int parent;				// The node's parent, or the next free node while the node is free
+		int child1;				// The node's first child, or -1 for leaves
+		int child2;				// The node's second child, or -1 for leaves
+		int height;				// The number of levels below the node, or -1 while the node is free
+
+		bool IsLeaf() const { return child1 == -1; }
+	};
+
+	/* ---- NODE FUNCTIONS ---- */
+	// Returns the ID of a node taken from the free list, growing the list of nodes if it's empty
+	int AllocateNode()
+	{
+		if (freeList == -1)
+		{
+			nodes.push_back(Node());
+			nodes.back().parent = freeList;
+			freeList = (int)nodes.size() - 1;
+		}
+
+		int node = freeList;
+		freeList = nodes[node].parent;
+		nodes[node].shape = nullptr;
+		nodes[node].parent = -1;
+		nodes[node].child1 = -1;
+		nodes[node].child2 = -1;
+		nodes[node].height = 0;
+		return node;
+	}
+	void FreeNode(int node) // Returns the specified node to the free list
+	{
+		nodes[node].parent = freeList;
+		nodes[node].height = -1;
+		freeList = node;
+	}
+
+	// Inserts the specified leaf beside the node it grows the tree the least by
+	void InsertLeaf(int leaf)
+	{
+		if (root == -1)
+		{
+			root = leaf;
+			nodes[root].parent = -1;
+			return;
+		}
+
+		/* --- FIND SIBLING --- */
+
+		// Descend while adding the leaf further down costs less than pairing it with the current node
+		// The cost of a node is its perimeter, and every branch above the leaf grows to contain it
+		glm::vec2 leafMin = nodes[leaf].min;
+		glm::vec2 leafMax = nodes[leaf].max;
+		int index = root;
+		while (!nodes[index].IsLeaf())
+		{
+			const Node& node = nodes[index];
+			float perimeter = GetPerimeter(node.min, node.max);
+			float combinedPerimeter = GetPerimeter(glm::min(node.min, leafMin), glm::max(node.max, leafMax));
+
+			// The cost of pairing the leaf with this node, and the growth every branch below here pays for it
+			float cost = 2.0f * combinedPerimeter;
+			float inheritedCost = 2.0f * (combinedPerimeter - perimeter);
+			float cost1 = GetDescentCost(node.child1, leafMin, leafMax) + inheritedCost;
+			float cost2 = GetDescentCost(node.child2, leafMin, leafMax) + inheritedCost;
+			if (cost < cost1 && cost < cost2)
+				break;
+			index = (cost1 < cost2) ? node.child1 : node.child2;
+		}
+		int sibling = index;
+
+		/* --- INSERT --- */
+
+		// Replace the sibling with a new branch holding both it and the leaf
+		int oldParent = nodes[sibling].parent;
+		int newParent = AllocateNode();
+		nodes[newParent].parent = oldParent;
+		nodes[newParent].min = glm::min(nodes[sibling].min, leafMin);
+		nodes[newParent].max = glm::max(nodes[sibling].max, leafMax);
+		nodes[newParent].height = nodes[sibling].height + 1;
+		nodes[newParent].child1 = sibling;
+		nodes[newParent].child2 = leaf;
+		nodes[sibling].parent = newParent;
+		nodes[leaf].parent = newParent;
+		if (oldParent == -1)
+			root = newParent;
+		else if (nodes[oldParent].child1 == sibling)
+			nodes[oldParent].child1 = newParent;
+		else
+			nodes[oldParent].child2 = newParent;
+
+		Refit(newParent);
+	}
+	// Removes the specified leaf, replacing its parent with its sibling
+	void RemoveLeaf(int leaf)
+	{
+		if (leaf == root)
+		{
+			root = -1;
+			return;
+		}
+
+		int parent = nodes[leaf].parent;
+		int grandParent = nodes[parent].parent;
+		int sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+		FreeNode(parent);
+		nodes[sibling].parent = grandParent;
+		if (grandParent == -1)
+		{
+			root = sibling;
+			return;
+		}
+
+		if (nodes[grandParent].child1 == parent)
+			nodes[grandParent].child1 = sibling;
+		else
+			nodes[grandParent].child2 = sibling;
+		Refit(grandParent);
+	}
+	// Rebalances the specified branch and every branch above it, and updates their boxes and heights to fit their children
+	void Refit(int index)
+	{
+		while (index != -1)
+		{
+			index = Balance(index);
+			Node& node = nodes[index];
+			const Node& child1 = nodes[node.child1];
+			const Node& child2 = nodes[node.child2];
+			node.min = glm::min(child1.min, child2.min);
+			node.max = glm::max(child1.max, child2.max);
+			node.height = 1 + std::max(child1.height, child2.height);
+			index = node.parent;
+		}
+	}
+	// If one child of the specified branch is more than a level taller than the other, rotates its taller grandchild up
+	// Returns the branch now in the specified branch's place
+	int Balance(int indexA)
+	{
+		Node& a = nodes[indexA];
+		if (a.IsLeaf() || a.height < 2)
+			return indexA;
+
+		int balance = nodes[a.child2].height - nodes[a.child1].height;
+		if (balance > 1)
+			return RotateUp(indexA, a.child2, a.child1, true);
+		if (balance < -1)
+			return RotateUp(indexA, a.child1, a.child2, false);
+		return indexA;
+	}
+	// Moves the specified taller child up into its parent's place, with the parent taking the child's shorter child in its place
+	// The parent keeps its other child, and the taller child keeps its taller child
+	int RotateUp(int indexA, int indexTall, int indexShort, bool isTallSecond)
+	{
+		Node& a = nodes[indexA];
+		Node& tall = nodes[indexTall];
+		int indexF = tall.child1;
+		int indexG = tall.child2;
+		if (nodes[indexF].height < nodes[indexG].height)
+			std::swap(indexF, indexG);
+
+		// The taller child takes the parent's place
+		tall.parent = a.parent;
+		a.parent = indexTall;
+		if (tall.parent == -1)
+			root = indexTall;
+		else if (nodes[tall.parent].child1 == indexA)
+			nodes[tall.parent].child1 = indexTall;
+		else
+			nodes[tall.parent].child2 = indexTall;
+
+		// The parent becomes a child of the taller child, and takes its shorter grandchild where the taller child used to be
+		tall.child1 = indexA;
+		tall.child2 = indexF;
+		if (isTallSecond)
+			a.child2 = indexG;
+		else
+			a.child1 = indexG;
+		nodes[indexG].parent = indexA;
+
+		const Node& shortChild = nodes[indexShort];
+		const Node& g = nodes[indexG];
+		const Node& f = nodes[indexF];
+		a.min = glm::min(shortChild.min, g.min);
+		a.max = glm::max(shortChild.max, g.max);
+		a.height = 1 + std::max(shortChild.height, g.height);
+		tall.min = glm::min(a.min, f.min);
+		tall.max = glm::max(a.max, f.max);
+		tall.height = 1 + std::max(a.height, f.height);
+		return indexTall;
+	}
+
+	// Calls the specified function for each leaf reached by descending through the nodes passing the specified test
+	template<typename Test, typename Function>
+	void Traverse(Test isPassing, Function callback) const
+	{
+		if (root == -1)
+			return;
+
+		// The tree is kept balanced, so the nodes still to visit never outgrow a small stack
+		assert(GetHeight() < MAX_STACK && "DynamicTree is too tall to traverse");
+		int stack[MAX_STACK];
+		int count = 0;
+		stack[count++] = root;
+		while (count > 0)
+		{
+			int index = stack[--count];
+			const Node& node = nodes[index];
+			if (!isPassing(node))
+				continue;
+
+			if (node.IsLeaf())
+			{
+				if (!callback(node.shape, index))
+					return;
+			}
+			else
+			{
+				stack[count++] = node.child1;
+				stack[count++] = node.child2;
+			}
+		}
+	}
+
+	/* ---- HELPER FUNCTIONS ---- */
+	// Returns the perimeter of the box with the specified minimum and maximum coordinates
+	static float GetPerimeter(glm::vec2 min, glm::vec2 max)
+	{
+		return 2.0f * ((max.x - min.x) + (max.y - min.y));
+	}
+	// Returns the cost of descending into the specified child to insert a leaf with the specified box
+	float GetDescentCost(int child, glm::vec2 leafMin, glm::vec2 leafMax) const
+	{
+		const Node& node = nodes[child];
+		float combinedPerimeter = GetPerimeter(glm::min(node.min, leafMin), glm::max(node.max, leafMax));
+		if (node.IsLeaf())
+			return combinedPerimeter;
+		return combinedPerimeter - GetPerimeter(node.min, node.max);
+	}
+	// Returns true if the specified node's box overlaps the specified region
+	static bool IsOverlapping(const Node& node, glm::vec2 min, glm::vec2 max)
+	{
+		return node.min.x <= max.x && min.x <= node.max.x && node.min.y <= max.y && min.y <= node.max.y;
+	}
+
+	/* ---- VARIABLES ---- */
+	std::vector<Node> nodes;		// Every node, including those in the free list
+	int root;						// The ID of the root node, or -1 if the tree is empty
+	int freeList;					// The ID of the first free node, or -1 if there are none
+	float margin;					// The distance the bounds of each shape are grown by on every side
+};
@@ -0,0 +1,186 @@
+#pragma once
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "BroadPhase.h"
+#include "ThreadPool.h"
+
+/* ------------------------------
+ISLANDSOLVER CLASS
+
+The IslandSolver runs the narrow phase and resolves collisions across
+several threads, by splitting the pairs from a broad phase into islands:
+groups of shapes that are linked through pairs, which can't affect any
+shape outside their own group.
+Islands are found with a union-find over the shapes of each pair, then
+handed out to a ThreadPool, with small islands grouped into one task so
+each task is worth waking a thread for.
+
+Planes are treated as static, so they don't link the shapes touching
+them into one island; a pair with a plane joins the island of its other
+shape. The resolve function passed must only change the two shapes of
+the collision it's given (and never a plane), and polygons must not be
+attached to or detached from shapes while Solve runs.
+Islands are numbered, and pairs within each run, in the order the pairs
+were passed, and each island is only ever run by one thread, so the
+results are the same whatever the number of threads.
+-------------------------------*/
+
+class IslandSolver
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the IslandSolver with the specified number of threads (including the calling thread), or one per core if 0
+	IslandSolver(int threadCount = 0) : pool(threadCount)
+	{
+		islandCount = 0;
+	}
+
+	/* ---- SOLVE FUNCTIONS ---- */
+	// Collides each of the specified pairs, passing those that overlap to the resolve function, one thread per island at a time
+	void Solve(const std::vector<ShapePair>& pairs, const std::function<void(const CollisionData& collision)>& resolve)
+	{
+		FindIslands(pairs);
+		if (islandCount == 0)
+			return;
+
+		// Group consecutive islands into tasks of at least a minimum number of pairs
+		taskStarts.clear();
+		for (int island = 0; island < islandCount; island++)
+		{
+			if (taskStarts.empty() || islandStarts[island] - islandStarts[taskStarts.back()] >= MIN_PAIRS_PER_TASK)
+				taskStarts.push_back(island);
+		}
+		taskStarts.push_back(islandCount);
+
+		// Run each task's islands in order on one thread
+		pool.Run((int)taskStarts.size() - 1, [&](int task, int)
+		{
+			int first = islandStarts[taskStarts[task]];
+			int last = islandStarts[taskStarts[task + 1]];
+			for (int i = first; i < last; i++)
+			{
+				const ShapePair& pair = pairs[islandPairs[i]];
+				CollisionData collision = CollideShapeToShape(*pair.shapeA, *pair.shapeB);
+				if (collision.depth > 0.0f)
+					resolve(collision);
+			}
+		});
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	int GetIslandCount() const // Returns the number of islands found by the last call to Solve
+	{
+		return islandCount;
+	}
+	int GetThreadCount() const // Returns the number of threads islands are run on, including the calling thread
+	{
+		return pool.GetWorkerCount();
+	}
+
+	/* ---- CONSTANTS ---- */
+	static constexpr int MIN_PAIRS_PER_TASK = 64;		// The fewest pairs handed to a thread at once, unless fewer are left
+
+private:
+	// Sorts the indices of the specified pairs by island, storing where each island's pairs start
+	void FindIslands(const std::vector<ShapePair>& pairs)
+	{
+		/* --- UNION --- */
+
+		// Number each shape other than planes, and join the two shapes of each pair
+		bodies.clear();
+		parents.clear();
+		pairBodies.resize(pairs.size());
+		for (size_t i = 0; i < pairs.size(); i++)
+		{
+			int bodyA = GetBody(pairs[i].shapeA);
+			int bodyB = GetBody(pairs[i].shapeB);
+			pairBodies[i] = (bodyA != -1) ? bodyA : bodyB;
+			if (bodyA != -1 && bodyB != -1)
+				Join(bodyA, bodyB);
+		}
+
+		/* --- ISLANDS --- */
+
+		// Number the islands in the order their first pair was passed, counting each island's pairs
+		islandOfRoot.assign(parents.size(), -1);
+		islandStarts.clear();
+		islandCount = 0;
+		for (int& body : pairBodies)
+		{
+			// Pairs of two planes have no island
+			if (body == -1)
+				continue;
+
+			int& island = islandOfRoot[FindRoot(body)];
+			if (island == -1)
+			{
+				island = islandCount++;
+				islandStarts.push_back(0);
+			}
+			islandStarts[island]++;
+			body = island;
+		}
+
+		// Place each pair after those of the islands before its own (a counting sort), keeping their order within each
+		int start = 0;
+		for (int& island : islandStarts)
+		{
+			int count = island;
+			island = start;
+			start += count;
+		}
+		islandStarts.push_back(start);
+		islandPairs.resize(start);
+		islandEnds.assign(islandStarts.begin(), islandStarts.end() - 1);
+		for (size_t i = 0; i < pairs.size(); i++)
+		{
+			if (pairBodies[i] != -1)
+				islandPairs[islandEnds[pairBodies[i]]++] = (int)i;
+		}
+	}
+
+	// Returns the number of the specified shape, numbering it if it's new, or -1 if it's a plane
+	int GetBody(Shape* shape)
+	{
+		if (shape->GetType() == ShapeType::Plane)
+			return -1;
+
+		auto body = bodies.emplace(shape, (int)parents.size());
+		if (body.second)
+			parents.push_back(body.first->second);
+		return body.first->second;
+	}
+	// Returns the body at the root of the specified body's set, pointing each body on the way at its grandparent
+	int FindRoot(int body)
+	{
+		while (parents[body] != body)
+		{
+			parents[body] = parents[parents[body]];
+			body = parents[body];
+		}
+		return body;
+	}
+	// Joins the sets of the two specified bodies
+	void Join(int bodyA, int bodyB)
+	{
+		int rootA = FindRoot(bodyA);
+		int rootB = FindRoot(bodyB);
+		if (rootA < rootB)
+			parents[rootB] = rootA;
+		else if (rootB < rootA)
+			parents[rootA] = rootB;
+	}
+
+	/* ---- VARIABLES ---- */
+	ThreadPool pool;								// The threads islands are run on
+	std::unordered_map<Shape*, int> bodies;		// The number of each shape other than planes in the pairs passed
+	std::vector<int> parents;						// The parent of each body in its set, or itself for the root
+	std::vector<int> pairBodies;					// A body of each pair passed, then the island of each pair (-1 for two planes)
+	std::vector<int> islandOfRoot;					// The island of each root body, or -1 if not yet numbered
+	std::vector<int> islandStarts;					// The index of the first pair of each island in islandPairs, followed by the total
+	std::vector<int> islandEnds;					// The index after the last pair placed for each island while sorting
+	std::vector<int> islandPairs;					// The index of each pair passed, sorted by island
+	std::vector<int> taskStarts;					// The first island of each task, followed by the number of islands
+	int islandCount;								// The number of islands found by the last call to Solve
+};
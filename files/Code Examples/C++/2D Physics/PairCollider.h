@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "BroadPhase.h"
+#include "ShapeTypeIndex.h"
+
+/* ------------------------------
+PAIRCOLLIDER CLASS
+
+The PairCollider runs the narrow phase over the pairs found by a broad
+phase, without working out which function to call for each pair.
+CollideShapeToShape looks up the types of both shapes for every pair,
+which is hard to predict when the pairs come in mixed order.
+
+Instead, pairs are first sorted into a bucket for each combination of
+shape types (with the shapes swapped to the order their function takes),
+then each bucket is run by a loop that only calls that one function, so
+nothing is looked up per pair and each call goes straight to the function.
+Shapes with a polygon attached have buckets of their own, run by the
+polygon collision functions, whatever the type of the shape.
+The edge that last separated each pair of polygons is kept from call to
+call (in an open addressing table, like the ContactCache's), so a pair
+that stays apart is usually let go after testing that one edge. Pairs no
+longer passed, or that overlap, have their edge dropped.
+Only collisions that overlap (have a positive depth) are kept, grouped
+by bucket rather than in the order of the pairs passed.
+-------------------------------*/
+
+class PairCollider
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes a PairCollider with no separating edges kept
+	PairCollider()
+	{
+		currentAxes = 0;
+		BuildAxisTable();
+	}
+
+	/* ---- COLLISION FUNCTIONS ---- */
+	// Stores collision information for each of the specified pairs that overlap, replacing the collisions' contents
+	void Collide(const std::vector<ShapePair>& pairs, std::vector<CollisionData>& collisions)
+	{
+		collisions.clear();
+
+		/* --- BUCKETS --- */
+
+		// Look up the combination of types in each pair once, counting the pairs in each bucket
+		int bucketCounts[BUCKET_COUNT] = {};
+		combinations.resize(pairs.size());
+		for (size_t i = 0; i < pairs.size(); i++)
+		{
+			int indexA = GetShapeIndex(*pairs[i].shapeA);
+			int indexB = GetShapeIndex(*pairs[i].shapeB);
+			int combination = (indexA == -1 || indexB == -1) ? NO_COMBINATION : indexA * SHAPE_TYPE_COUNT + indexB;
+			combinations[i] = (unsigned char)combination;
+			bucketCounts[GetBucketInfo(combination).bucket]++;
+		}
+
+		// Place each pair after those of the buckets before its own (a counting sort), in the order its function takes
+		int bucketStarts[BUCKET_COUNT + 1] = {};
+		for (int bucket = 0; bucket < BUCKET_COUNT; bucket++)
+			bucketStarts[bucket + 1] = bucketStarts[bucket] + bucketCounts[bucket];
+		sorted.resize(bucketStarts[BUCKET_COUNT]);
+		int bucketEnds[BUCKET_COUNT + 1];
+		std::copy(bucketStarts, bucketStarts + BUCKET_COUNT + 1, bucketEnds);
+		for (size_t i = 0; i < pairs.size(); i++)
+		{
+			const BucketInfo& info = GetBucketInfo(combinations[i]);
+			ShapePair& pair = sorted[bucketEnds[info.bucket]++];
+			pair.shapeA = info.isSwapped ? pairs[i].shapeB : pairs[i].shapeA;
+			pair.shapeB = info.isSwapped ? pairs[i].shapeA : pairs[i].shapeB;
+		}
+
+		/* --- COLLISION --- */
+
+		// Run each bucket by a loop that only calls its own function
+		const ShapePair* bucketPairs[BUCKET_COUNT];
+		for (int bucket = 0; bucket < BUCKET_COUNT; bucket++)
+			bucketPairs[bucket] = sorted.data() + bucketStarts[bucket];
+		CollideBucket<Square, Square, CollideSquareToSquare>(bucketPairs[SQUARE_SQUARE], bucketCounts[SQUARE_SQUARE], collisions);
+		CollideBucket<Square, Plane, CollideSquareToPlane>(bucketPairs[SQUARE_PLANE], bucketCounts[SQUARE_PLANE], collisions);
+		CollideBucket<Circle, Square, CollideCircleToSquare>(bucketPairs[CIRCLE_SQUARE], bucketCounts[CIRCLE_SQUARE], collisions);
+		CollideBucket<Circle, Circle, CollideCircleToCircle>(bucketPairs[CIRCLE_CIRCLE], bucketCounts[CIRCLE_CIRCLE], collisions);
+		CollideBucket<Circle, Plane, CollideCircleToPlane>(bucketPairs[CIRCLE_PLANE], bucketCounts[CIRCLE_PLANE], collisions);
+		CollideBucket<ConvexPolygon, Square, CollidePolygonToSquare>(bucketPairs[POLYGON_SQUARE], bucketCounts[POLYGON_SQUARE], collisions);
+		CollideBucket<ConvexPolygon, Circle, CollidePolygonToCircle>(bucketPairs[POLYGON_CIRCLE], bucketCounts[POLYGON_CIRCLE], collisions);
+		CollideBucket<ConvexPolygon, Plane, CollidePolygonToPlane>(bucketPairs[POLYGON_PLANE], bucketCounts[POLYGON_PLANE], collisions);
+		CollidePolygonBucket(bucketPairs[POLYGON_POLYGON], bucketCounts[POLYGON_POLYGON], collisions);
+	}
+
+private:
+	// Each combination of shape types, in the order their collision function takes them
+	// Pairs that can't collide are sorted into the last bucket, which isn't run
+	enum Bucket
+	{
+		SQUARE_SQUARE,
+		SQUARE_PLANE,
+		CIRCLE_SQUARE,
+		CIRCLE_CIRCLE,
+		CIRCLE_PLANE,
+		POLYGON_SQUARE,
+		POLYGON_CIRCLE,
+		POLYGON_PLANE,
+		POLYGON_POLYGON,
+		NO_BUCKET,
+		BUCKET_COUNT
+	};
+	// The edge that last separated a pair of polygons, kept until they overlap or stop being passed
+	struct PairAxis
+	{
+		const Shape* shapeA;	// The shape whose polygon the axis calls polygon 0
+		const Shape* shapeB;	// The shape whose polygon the axis calls polygon 1
+		SeparatingAxis axis;	// The edge that separated them
+	};
+	// The bucket for a combination of shape types, and whether its shapes need swapping to suit its function
+	struct BucketInfo
+	{
+		int bucket;			// The bucket the pair belongs in
+		bool isSwapped;		// Whether shape B is passed to the function first
+	};
+
+	static constexpr int NO_COMBINATION = SHAPE_TYPE_COUNT * SHAPE_TYPE_COUNT;	// The combination of a pair with a shape of any other type
+
+	// Returns the bucket for the specified combination of shape types (GetShapeIndex of shape A times SHAPE_TYPE_COUNT plus that of shape B)
+	// The table is a local static rather than a static member, so binding a reference to it needs no definition outside the class before C++17
+	static const BucketInfo& GetBucketInfo(int combination)
+	{
+		static const BucketInfo buckets[NO_COMBINATION + 1] =
+		{
+			// Square and...
+			{ SQUARE_SQUARE, false }, { CIRCLE_SQUARE, true }, { SQUARE_PLANE, false }, { POLYGON_SQUARE, true },
+			// Circle and...
+			{ CIRCLE_SQUARE, false }, { CIRCLE_CIRCLE, false }, { CIRCLE_PLANE, false }, { POLYGON_CIRCLE, true },
+			// Plane and...
+			{ SQUARE_PLANE, true }, { CIRCLE_PLANE, true }, { NO_BUCKET, false }, { POLYGON_PLANE, true },
+			// Polygon and...
+			{ POLYGON_SQUARE, false }, { POLYGON_CIRCLE, false }, { POLYGON_PLANE, false }, { POLYGON_POLYGON, false },
+			// Any other type
+			{ NO_BUCKET, false }
+		};
+		return buckets[combination];
+	}
+
+	// Returns the specified shape as the type passed, or the polygon attached to it if a polygon is passed
+	template<typename Type>
+	static const Type& GetAs(const Shape* shape, const Type*)
+	{
+		return *(const Type*)shape;
+	}
+	static const ConvexPolygon& GetAs(const Shape* shape, const ConvexPolygon*)
+	{
+		return *GetShapePolygon(shape);
+	}
+
+	// Stores collision information for each of the specified pairs that overlap, all of which are of the function's types
+	template<typename TypeA, typename TypeB, CollisionData(*Function)(const TypeA&, const TypeB&)>
+	static void CollideBucket(const ShapePair* pairs, int count, std::vector<CollisionData>& collisions)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			CollisionData collision = Function(GetAs(pairs[i].shapeA, (const TypeA*)nullptr), GetAs(pairs[i].shapeB, (const TypeB*)nullptr));
+			if (collision.depth > 0.0f)
+				collisions.push_back(collision);
+		}
+	}
+
+	// Stores collision information for each of the specified pairs of polygons that overlap, trying the edge that last separated each first
+	void CollidePolygonBucket(const ShapePair* pairs, int count, std::vector<CollisionData>& collisions)
+	{
+		// Edges still separating a pair are copied into the other list, so the rest are simply left behind
+		const std::vector<PairAxis>& last = axes[currentAxes];
+		std::vector<PairAxis>& next = axes[1 - currentAxes];
+		next.clear();
+		for (int i = 0; i < count; i++)
+		{
+			PairAxis pairAxis;
+			pairAxis.shapeA = pairs[i].shapeA;
+			pairAxis.shapeB = pairs[i].shapeB;
+			int index = FindAxis(pairs[i]);
+			if (index != -1)
+			{
+				// The edge's polygon is numbered by its place in the pair, which may have been passed the other way round last time
+				pairAxis.axis = last[index].axis;
+				if (last[index].shapeA != pairs[i].shapeA)
+					pairAxis.axis.polygon = 1 - pairAxis.axis.polygon;
+			}
+
+			CollisionData collision = CollidePolygonToPolygon(*GetShapePolygon(pairs[i].shapeA), *GetShapePolygon(pairs[i].shapeB), &pairAxis.axis);
+			if (collision.depth > 0.0f)
+				collisions.push_back(collision);
+			if (pairAxis.axis.polygon != -1)
+				next.push_back(pairAxis);
+		}
+
+		currentAxes = 1 - currentAxes;
+		BuildAxisTable();
+	}
+	// Returns the index of the specified pair's separating edge from the last call, or -1 if it had none
+	int FindAxis(const ShapePair& pair) const
+	{
+		// Look through the slots from the pair's own until an empty one
+		const std::vector<PairAxis>& last = axes[currentAxes];
+		for (size_t slot = GetAxisSlot(pair.shapeA, pair.shapeB);; slot = (slot + 1) & (axisTable.size() - 1))
+		{
+			int index = axisTable[slot];
+			if (index == -1)
+				return -1;
+
+			const PairAxis& pairAxis = last[index];
+			if ((pairAxis.shapeA == pair.shapeA && pairAxis.shapeB == pair.shapeB) || (pairAxis.shapeA == pair.shapeB && pairAxis.shapeB == pair.shapeA))
+				return index;
+		}
+	}
+	// Rebuilds the table of slots from the current separating edges, at least twice as big as the number of edges so it's never full
+	void BuildAxisTable()
+	{
+		const std::vector<PairAxis>& current = axes[currentAxes];
+		size_t size = 16;
+		while (size < current.size() * 2)
+			size *= 2;
+		axisTable.assign(size, -1);
+
+		for (int index = 0; index < (int)current.size(); index++)
+		{
+			size_t slot = GetAxisSlot(current[index].shapeA, current[index].shapeB);
+			while (axisTable[slot] != -1)
+				slot = (slot + 1) & (size - 1);
+			axisTable[slot] = index;
+		}
+	}
+	// Returns the slot of the table a pair of shapes is looked for from, the same whichever order they're in
+	size_t GetAxisSlot(const Shape* shapeA, const Shape* shapeB) const
+	{
+		return (size_t)(GetShapePairHash(shapeA, shapeB) >> 32) & (axisTable.size() - 1);
+	}
+
+	/* ---- VARIABLES ---- */
+	std::vector<unsigned char> combinations;	// The combination of shape types in each pair passed
+	std::vector<ShapePair> sorted;				// Each pair passed, sorted by bucket
+	std::vector<PairAxis> axes[2];				// The edges that separated pairs of polygons last call, and those found this call, swapping each call
+	std::vector<int> axisTable;					// The index of an edge from last call in each slot, or -1 if empty (open addressing)
+	int currentAxes;							// Which of the lists of edges holds those found last call
+};
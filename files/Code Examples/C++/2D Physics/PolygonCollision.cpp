@@ -0,0 +1,278 @@
+#include "PolygonCollision.h"
+#include <algorithm>
+#include <cfloat>
+
+// How much less one polygon's edges must overlap than the other's to be picked as the reference, so it doesn't flicker between them
+static const float REFERENCE_TOLERANCE = 0.001f;
+
+// Return collision information for two unrotated boxes, the same way as CollideSquareToSquare.
+static CollisionData CollideAxisAlignedBoxes(const ConvexPolygon& boxA, const ConvexPolygon& boxB)
+{
+	CollisionData result;
+	glm::vec2 boxAMin = boxA.GetMinCoordinates(), boxAMax = boxA.GetMaxCoordinates();
+	glm::vec2 boxBMin = boxB.GetMinCoordinates(), boxBMax = boxB.GetMaxCoordinates();
+
+	// Calculate the overlap distance on both axes, and store the minimum
+	float xOverlap1 = boxAMax.x - boxBMin.x;
+	float xOverlap2 = boxBMax.x - boxAMin.x;
+	float yOverlap1 = boxAMax.y - boxBMin.y;
+	float yOverlap2 = boxBMax.y - boxAMin.y;
+	float minOverlap = std::min({ xOverlap1, xOverlap2, yOverlap1, yOverlap2 });
+
+	// Calculate and store depth and normal based on the minimum overlap
+	result.depth = minOverlap;
+	result.normal =
+		(minOverlap == xOverlap1) ? glm::vec2(1.0f, 0.0f) :
+		(minOverlap == xOverlap2) ? glm::vec2(-1.0f, 0.0f) :
+		(minOverlap == yOverlap1) ? glm::vec2(0.0f, 1.0f) :
+		glm::vec2(0.0f, -1.0f);
+
+	// Calculate and store the mid point position based on an average
+	result.worldPos.x = (std::min(boxAMax.x, boxBMax.x) + std::max(boxAMin.x, boxBMin.x)) / 2.0f;
+	result.worldPos.y = (std::min(boxAMax.y, boxBMax.y) + std::max(boxAMin.y, boxBMin.y)) / 2.0f;
+
+	result.shapeA = boxA.GetShape();
+	result.shapeB = boxB.GetShape();
+	return result;
+}
+
+// Returns how far the other polygon's nearest vertex is in front of the specified edge of the first (negative if behind it).
+static float GetEdgeSeparation(const ConvexPolygon& polygon, int edge, const ConvexPolygon& other)
+{
+	glm::vec2 normal = polygon.GetNormal(edge);
+	glm::vec2 vertex = polygon.GetVertex(edge);
+	float separation = FLT_MAX;
+	for (int i = 0; i < other.GetVertexCount(); i++)
+		separation = std::min(separation, glm::dot(normal, other.GetVertex(i) - vertex));
+	return separation;
+}
+
+// Stores the edge of the first polygon the other is furthest in front of, returning how far, or the first edge it's entirely in front of.
+static float FindMaxSeparation(const ConvexPolygon& polygon, const ConvexPolygon& other, int* edge)
+{
+	float maxSeparation = -FLT_MAX;
+	for (int i = 0; i < polygon.GetVertexCount(); i++)
+	{
+		float separation = GetEdgeSeparation(polygon, i, other);
+		if (separation > maxSeparation)
+		{
+			maxSeparation = separation;
+			*edge = i;
+		}
+
+		// Any edge with the other entirely in front of it separates them, so there's no need to look further
+		if (separation > 0.0f)
+			break;
+	}
+	return maxSeparation;
+}
+
+// Clips the segment between the two points to the side of the line (through the specified point) the direction points away from, returning false if none is left.
+static bool ClipSegment(glm::vec2* pointA, glm::vec2* pointB, glm::vec2 linePoint, glm::vec2 direction)
+{
+	float distanceA = glm::dot(direction, *pointA - linePoint);
+	float distanceB = glm::dot(direction, *pointB - linePoint);
+	if (distanceA > 0.0f && distanceB > 0.0f)
+		return false;
+
+	// Move whichever point is past the line back onto it
+	if (distanceA > 0.0f)
+		*pointA = *pointA + (*pointB - *pointA) * (distanceA / (distanceA - distanceB));
+	else if (distanceB > 0.0f)
+		*pointB = *pointB + (*pointA - *pointB) * (distanceB / (distanceB - distanceA));
+	return true;
+}
+
+// Return collision information for two potentially-colliding ConvexPolygons, trying the specified pair's last separating edge first if passed.
+CollisionData CollidePolygonToPolygon(const ConvexPolygon& polygonA, const ConvexPolygon& polygonB, SeparatingAxis* axis)
+{
+	if (polygonA.IsAxisAligned() && polygonB.IsAxisAligned())
+		return CollideAxisAlignedBoxes(polygonA, polygonB);
+
+	CollisionData result;
+	result.shapeA = polygonA.GetShape();
+	result.shapeB = polygonB.GetShape();
+
+	/* --- SEPARATION --- */
+
+	// Try the edge that separated the polygons last time first, as it usually still does
+	if (axis != nullptr && axis->polygon != -1)
+	{
+		const ConvexPolygon& polygon = (axis->polygon == 0) ? polygonA : polygonB;
+		const ConvexPolygon& other = (axis->polygon == 0) ? polygonB : polygonA;
+		if (axis->edge < polygon.GetVertexCount())
+		{
+			float separation = GetEdgeSeparation(polygon, axis->edge, other);
+			if (separation > 0.0f)
+			{
+				result.depth = -separation;
+				return result;
+			}
+		}
+	}
+
+	// Find the edge of either polygon the other is furthest in front of, stopping at any that separates them
+	int edgeA = 0, edgeB = 0;
+	float separationA = FindMaxSeparation(polygonA, polygonB, &edgeA);
+	float separationB = (separationA > 0.0f) ? separationA : FindMaxSeparation(polygonB, polygonA, &edgeB);
+	if (separationA > 0.0f || separationB > 0.0f)
+	{
+		if (axis != nullptr)
+		{
+			axis->polygon = (separationA > 0.0f) ? 0 : 1;
+			axis->edge = (separationA > 0.0f) ? edgeA : edgeB;
+		}
+		result.depth = -std::max(separationA, separationB);
+		return result;
+	}
+	if (axis != nullptr)
+		axis->polygon = -1;
+
+	/* --- COLLISION --- */
+
+	// The polygons overlap least along the edge they're most separated along, which becomes the reference edge
+	bool isReferenceB = separationB > separationA + REFERENCE_TOLERANCE;
+	const ConvexPolygon& reference = isReferenceB ? polygonB : polygonA;
+	const ConvexPolygon& incident = isReferenceB ? polygonA : polygonB;
+	int referenceEdge = isReferenceB ? edgeB : edgeA;
+	glm::vec2 referenceNormal = reference.GetNormal(referenceEdge);
+	result.depth = -(isReferenceB ? separationB : separationA);
+	result.normal = isReferenceB ? -referenceNormal : referenceNormal;
+
+	// The incident edge is the one facing most against the reference edge
+	int incidentEdge = 0;
+	float minDot = FLT_MAX;
+	for (int i = 0; i < incident.GetVertexCount(); i++)
+	{
+		float dot = glm::dot(referenceNormal, incident.GetNormal(i));
+		if (dot < minDot)
+		{
+			minDot = dot;
+			incidentEdge = i;
+		}
+	}
+
+	// Clip the incident edge to the sides of the reference edge
+	glm::vec2 referenceStart = reference.GetVertex(referenceEdge);
+	glm::vec2 referenceEnd = reference.GetVertex((referenceEdge + 1) % reference.GetVertexCount());
+	glm::vec2 tangent = glm::normalize(referenceEnd - referenceStart);
+	glm::vec2 pointA = incident.GetVertex(incidentEdge);
+	glm::vec2 pointB = incident.GetVertex((incidentEdge + 1) % incident.GetVertexCount());
+	if (!ClipSegment(&pointA, &pointB, referenceStart, -tangent) || !ClipSegment(&pointA, &pointB, referenceEnd, tangent))
+	{
+		result.worldPos = (pointA + pointB) * 0.5f;
+		return result;
+	}
+
+	// Store the mid point of the clipped points behind the reference edge
+	bool isBehindA = glm::dot(referenceNormal, pointA - referenceStart) <= 0.0f;
+	bool isBehindB = glm::dot(referenceNormal, pointB - referenceStart) <= 0.0f;
+	result.worldPos =
+		(isBehindA && !isBehindB) ? pointA :
+		(isBehindB && !isBehindA) ? pointB :
+		(pointA + pointB) * 0.5f;
+	return result;
+}
+
+// Return collision information for a potentially-colliding ConvexPolygon and Square.
+CollisionData CollidePolygonToSquare(const ConvexPolygon& polygon, const Square& square)
+{
+	// The square is collided as an unrotated box, kept for each thread so its vertices are only set again when its size changes
+	static thread_local ConvexPolygon box;
+	static thread_local glm::vec2 boxExtents(0.0f, 0.0f);
+	glm::vec2 squareMin, squareMax;
+	square.GetCoordinates(&squareMin, &squareMax);
+	glm::vec2 extents = (squareMax - squareMin) * 0.5f;
+	if (box.GetVertexCount() == 0 || extents != boxExtents)
+	{
+		box.SetBox(extents);
+		boxExtents = extents;
+	}
+	box.SetTransform((squareMin + squareMax) * 0.5f, 0.0f);
+
+	CollisionData result = CollidePolygonToPolygon(polygon, box);
+	result.shapeB = (Shape*)&square;
+	return result;
+}
+
+// Return collision information for a potentially-colliding ConvexPolygon and Circle.
+CollisionData CollidePolygonToCircle(const ConvexPolygon& polygon, const Circle& circle)
+{
+	CollisionData result;
+	result.shapeA = polygon.GetShape();
+	result.shapeB = (Shape*)&circle;
+
+	// Find the edge the circle's centre is furthest in front of, letting go as soon as it's clear of one
+	int edge = 0;
+	float maxSeparation = -FLT_MAX;
+	for (int i = 0; i < polygon.GetVertexCount(); i++)
+	{
+		float separation = glm::dot(polygon.GetNormal(i), circle.position - polygon.GetVertex(i));
+		if (separation > circle.radius)
+		{
+			result.depth = circle.radius - separation;
+			return result;
+		}
+		if (separation > maxSeparation)
+		{
+			maxSeparation = separation;
+			edge = i;
+		}
+	}
+
+	// Past either end of the edge, the nearest point of the polygon is that end's vertex
+	glm::vec2 vertexA = polygon.GetVertex(edge);
+	glm::vec2 vertexB = polygon.GetVertex((edge + 1) % polygon.GetVertexCount());
+	bool isPastA = maxSeparation > 0.0f && glm::dot(circle.position - vertexA, vertexB - vertexA) <= 0.0f;
+	bool isPastB = maxSeparation > 0.0f && glm::dot(circle.position - vertexB, vertexA - vertexB) <= 0.0f;
+	if (isPastA || isPastB)
+	{
+		glm::vec2 vertex = isPastA ? vertexA : vertexB;
+		glm::vec2 difference = circle.position - vertex;
+		float distance = glm::length(difference);
+		result.depth = circle.radius - distance;
+		result.normal = difference / distance;
+		result.worldPos = vertex;
+		return result;
+	}
+
+	// Otherwise the centre is inside, or in front of the middle of the edge
+	result.depth = circle.radius - maxSeparation;
+	result.normal = polygon.GetNormal(edge);
+	result.worldPos = circle.position - result.normal * maxSeparation;
+	return result;
+}
+
+// Return collision information for a potentially-colliding ConvexPolygon and Plane.
+CollisionData CollidePolygonToPlane(const ConvexPolygon& polygon, const Plane& plane)
+{
+	CollisionData result;
+	result.shapeA = polygon.GetShape();
+	result.shapeB = (Shape*)&plane;
+	result.normal = -plane.normal;
+
+	// An unrotated box's vertex furthest behind the plane is the corner picked by the signs of the plane's normal
+	if (polygon.IsAxisAligned())
+	{
+		glm::vec2 boxMin = polygon.GetMinCoordinates();
+		glm::vec2 boxMax = polygon.GetMaxCoordinates();
+		result.worldPos = glm::vec2(
+			(plane.normal.x > 0.0f) ? boxMin.x : boxMax.x,
+			(plane.normal.y > 0.0f) ? boxMin.y : boxMax.y);
+		result.depth = plane.offset - glm::dot(result.worldPos, plane.normal);
+		return result;
+	}
+
+	// Otherwise project every vertex onto the plane, storing the one furthest behind it
+	result.depth = -FLT_MAX;
+	for (int i = 0; i < polygon.GetVertexCount(); i++)
+	{
+		float depth = plane.offset - glm::dot(polygon.GetVertex(i), plane.normal);
+		if (depth > result.depth)
+		{
+			result.depth = depth;
+			result.worldPos = polygon.GetVertex(i);
+		}
+	}
+	return result;
+}
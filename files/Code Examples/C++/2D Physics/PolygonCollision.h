@@ -0,0 +1,62 @@
+#pragma once
+#include "ConvexPolygon.h"
+
+/* ------------------------------
+POLYGON COLLISION
+
+Collision functions for ConvexPolygons, using the separating axis test:
+two convex shapes don't overlap if there is an edge normal of either one
+along which they don't overlap, otherwise they overlap least along one
+of them, which gives the depth and normal of the collision.
+
+The last edge that separated a pair can be kept in a SeparatingAxis and
+passed in again, which is tried first. Pairs that are close but apart
+tend to stay apart along the same edge from step to step, so most are
+let go after one edge rather than all of them.
+Two unrotated boxes skip the test, colliding the same way as squares.
+
+A polygon is attached to the shape it belongs to (usually a square) to
+put it into the rest of the pipeline: from then on GetShapeBounds gives
+the polygon's bounds, and CollideShapeToShape, the PairCollider and the
+ContactCache collide the shape as the polygon. The link is kept on the
+shape itself, so finding a shape's polygon is a single load.
+Polygons must not be attached or detached (nor moved) while shapes are
+being collided on other threads, such as during IslandSolver::Solve.
+-------------------------------*/
+
+// The edge that last separated a pair of polygons, to be tried first the next time they're collided
+struct SeparatingAxis
+{
+	int polygon = -1;		// The polygon whose edge separated them (0 for A, 1 for B), or -1 if none did
+	int edge = 0;			// The index of the edge of that polygon
+};
+
+// Attaches the specified polygon to the shape it belongs to, so the shape is bounded and collided as the polygon until detached
+inline void AttachPolygon(const ConvexPolygon* polygon)
+{
+	polygon->GetShape()->polygon = polygon;
+}
+
+// Detaches the polygon attached to the specified shape, if any, so the shape is bounded and collided by its own type again
+inline void DetachPolygon(Shape* shape)
+{
+	shape->polygon = nullptr;
+}
+
+// Returns the polygon attached to the specified shape, or nullptr if it has none
+inline const ConvexPolygon* GetShapePolygon(const Shape* shape)
+{
+	return shape->polygon;
+}
+
+// Return collision information for two potentially-colliding ConvexPolygons, trying the specified pair's last separating edge first if passed.
+CollisionData CollidePolygonToPolygon(const ConvexPolygon& polygonA, const ConvexPolygon& polygonB, SeparatingAxis* axis = nullptr);
+
+// Return collision information for a potentially-colliding ConvexPolygon and Square.
+CollisionData CollidePolygonToSquare(const ConvexPolygon& polygon, const Square& square);
+
+// Return collision information for a potentially-colliding ConvexPolygon and Circle.
+CollisionData CollidePolygonToCircle(const ConvexPolygon& polygon, const Circle& circle);
+
+// Return collision information for a potentially-colliding ConvexPolygon and Plane.
+CollisionData CollidePolygonToPlane(const ConvexPolygon& polygon, const Plane& plane);
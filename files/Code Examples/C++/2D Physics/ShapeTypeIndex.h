@@ -0,0 +1,37 @@
+#pragma once
+#include "PolygonCollision.h"
+
+/* ------------------------------
+SHAPE TYPE INDEX
+
+The row or column each shape type has in the tables that pick what to do
+for a pair of shapes: the collision function table of CollideShapeToShape
+and the bucket table of the PairCollider. Both are indexed through here,
+so a new shape type only has to be numbered once.
+A shape with a polygon attached has the last row and column whatever its
+type, as it's collided as the polygon.
+-------------------------------*/
+
+// The number of rows and columns in the tables: one for each shape type, then one for shapes with a polygon attached
+constexpr int SHAPE_TYPE_COUNT = 4;
+
+// The row and column of shapes with a polygon attached
+constexpr int POLYGON_TYPE_INDEX = 3;
+
+// Returns the row or column of the tables for the type passed, or -1 if it has none
+inline int GetShapeTypeIndex(ShapeType type)
+{
+	switch (type)
+	{
+	case ShapeType::Square:		return 0;
+	case ShapeType::Circle:		return 1;
+	case ShapeType::Plane:		return 2;
+	default:					return -1;
+	}
+}
+
+// Returns the row or column of the tables for the specified shape, or -1 if it has none
+inline int GetShapeIndex(const Shape& shape)
+{
+	return (GetShapePolygon(&shape) != nullptr) ? POLYGON_TYPE_INDEX : GetShapeTypeIndex(shape.GetType());
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* ------------------------------
+THREADPOOL CLASS
+
+The ThreadPool runs a batch of numbered tasks across a fixed set of
+worker threads, using work stealing to keep them busy.
+Tasks are dealt out evenly to each worker's own queue. A worker takes
+tasks from the back of its own queue, and once that is empty steals from
+the front of the other workers' queues, so uneven tasks still finish at
+roughly the same time.
+The calling thread takes part as worker 0, and each task is told which
+worker is running it, so callers can keep per-worker scratch data.
+
+Each example project builds on its own, so this file is deliberately
+copied into both A-Star Pathfinding and 2D Physics rather than shared.
+The two copies must be kept identical: any change made here has to be
+made to A-Star Pathfinding/ThreadPool.h as well.
+-------------------------------*/
+
+class ThreadPool
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the ThreadPool with the specified number of workers (including the calling thread), or one per core if 0
+	ThreadPool(int workerCount = 0)
+	{
+		// Use one worker per core by default
+		if (workerCount <= 0)
+			workerCount = (int)std::thread::hardware_concurrency();
+		if (workerCount <= 0)
+			workerCount = 1;
+
+		// Create a task queue per worker, and a thread for every worker except the calling thread
+		job = nullptr;
+		batchId = 0;
+		busyThreads = 0;
+		remaining = 0;
+		stopping = false;
+		for (int i = 0; i < workerCount; i++)
+			queues.push_back(std::unique_ptr<TaskQueue>(new TaskQueue()));
+		for (int i = 1; i < workerCount; i++)
+			threads.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+	}
+	// Stops and joins all worker threads
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(batchLock);
+			stopping = true;
+		}
+		batchStart.notify_all();
+
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+	/* ---- RUN FUNCTIONS ---- */
+	// Runs the specified function once for every task index below the specified count, returning when all have finished
+	// The function is passed the task index and the index of the worker running it
+	void Run(int taskCount, const std::function<void(int task, int worker)>& function)
+	{
+		if (taskCount <= 0)
+			return;
+
+		// Deal the tasks out to each worker's queue and wake the workers
+		{
+			std::lock_guard<std::mutex> lock(batchLock);
+			job = &function;
+			remaining = taskCount;
+			for (int task = 0; task < taskCount; task++)
+			{
+				TaskQueue& queue = *queues[task % queues.size()];
+				std::lock_guard<std::mutex> queueLock(queue.lock);
+				queue.tasks.push_back(task);
+			}
+			batchId++;
+		}
+		batchStart.notify_all();
+
+		// Work on the batch from this thread too, then wait for the other workers to finish
+		WorkOn(0);
+		std::unique_lock<std::mutex> lock(batchLock);
+		batchDone.wait(lock, [this] { return remaining == 0 && busyThreads == 0; });
+		job = nullptr;
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	int GetWorkerCount() const // Returns the number of workers, including the calling thread
+	{
+		return (int)queues.size();
+	}
+
+private:
+	/* ---- NESTED CLASSES/STRUCTS ---- */
+	struct TaskQueue
+	{
+		std::mutex lock;				// Guards the task queue
+		std::deque<int> tasks;			// The task indices waiting to be run
+	};
+
+	// Waits for batches to start and works on them, until the ThreadPool is destroyed
+	void WorkerLoop(int worker)
+	{
+		unsigned int lastBatch = 0;
+		std::unique_lock<std::mutex> lock(batchLock);
+		while (true)
+		{
+			batchStart.wait(lock, [&] { return stopping || batchId != lastBatch; });
+			if (stopping)
+				return;
+
+			// Work on the batch without holding the lock
+			lastBatch = batchId;
+			busyThreads++;
+			lock.unlock();
+			WorkOn(worker);
+			lock.lock();
+			busyThreads--;
+
+			if (busyThreads == 0 && remaining == 0)
+				batchDone.notify_all();
+		}
+	}
+	// Runs tasks from the specified worker's queue, then steals from the others until no tasks are left
+	void WorkOn(int worker)
+	{
+		int task;
+		while (TakeTask(worker, task))
+		{
+			(*job)(task, worker);
+
+			// Wake the calling thread if that was the last task
+			if (--remaining == 0)
+			{
+				std::lock_guard<std::mutex> lock(batchLock);
+				batchDone.notify_all();
+			}
+		}
+	}
+	// Takes a task from the back of the specified worker's queue, or from the front of another's, returning false if none are left
+	bool TakeTask(int worker, int& task)
+	{
+		// Try own queue first
+		{
+			TaskQueue& own = *queues[worker];
+			std::lock_guard<std::mutex> lock(own.lock);
+			if (!own.tasks.empty())
+			{
+				task = own.tasks.back();
+				own.tasks.pop_back();
+				return true;
+			}
+		}
+
+		// Steal from the other workers, starting with the next one along
+		int count = (int)queues.size();
+		for (int i = 1; i < count; i++)
+		{
+			TaskQueue& other = *queues[(worker + i) % count];
+			std::lock_guard<std::mutex> lock(other.lock);
+			if (!other.tasks.empty())
+			{
+				task = other.tasks.front();
+				other.tasks.pop_front();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/* ---- VARIABLES ---- */
+	std::vector<std::unique_ptr<TaskQueue>> queues;			// The task queue of each worker
+	std::vector<std::thread> threads;						// The worker threads (worker 0 is the calling thread)
+
+	std::mutex batchLock;									// Guards the batch state below
+	std::condition_variable batchStart;						// Signalled when a batch starts or the ThreadPool is stopping
+	std::condition_variable batchDone;						// Signalled when the last task or busy thread finishes
+	const std::function<void(int, int)>* job;				// The function being run for the current batch
+	unsigned int batchId;									// Incremented for every batch, so workers can tell a new one has started
+	int busyThreads;										// The number of worker threads currently working on a batch
+	std::atomic<int> remaining;								// The number of tasks in the current batch yet to finish
+	bool stopping;											// Whether the worker threads should exit
+};
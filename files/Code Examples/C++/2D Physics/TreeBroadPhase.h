@@ -0,0 +1,176 @@
+#pragma once
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "BroadPhase.h"
+#include "DynamicTree.h"
+
+/* ------------------------------
+TREEBROADPHASE CLASS
+
+The TreeBroadPhase finds which shapes could be colliding using a
+DynamicTree, for scenes that keep the same shapes from step to step.
+Unlike the BroadPhase, shapes are added and removed once rather than
+passed in each step, and the pairs found are kept between steps.
+
+Each step, a shape is only looked at again if it has left its fattened
+box in the tree. Only those shapes are queried against the tree for new
+pairs, and pairs are dropped once their fattened boxes stop overlapping.
+In a mostly-still scene, a step costs little more than checking each
+shape's bounds against its fattened box.
+As pairs are found from fattened boxes, some won't quite be touching;
+CollideShapeToShape still decides which actually collide.
+Planes have no bounds, so each step each plane queries the tree for the
+shapes reaching behind it instead.
+-------------------------------*/
+
+class TreeBroadPhase
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes an empty TreeBroadPhase, fattening the bounds of each shape by the specified margin
+	TreeBroadPhase(float margin = DynamicTree::DEFAULT_MARGIN) : tree(margin)
+	{
+	}
+
+	/* ---- SHAPE FUNCTIONS ---- */
+	// Adds the specified shape, to be paired from the next call to FindPairs
+	void AddShape(Shape* shape)
+	{
+		int proxy = tree.CreateProxy(shape);
+		if (proxy == -1)
+		{
+			planes.push_back(shape);
+			return;
+		}
+
+		slots[shape] = (int)proxies.size();
+		proxies.push_back(proxy);
+		moved.push_back(proxy);
+	}
+	// Removes the specified shape, along with every pair it's part of
+	void RemoveShape(Shape* shape)
+	{
+		auto slot = slots.find(shape);
+		if (slot == slots.end())
+		{
+			planes.erase(std::remove(planes.begin(), planes.end(), shape), planes.end());
+			return;
+		}
+
+		// Drop the shape's pairs and any pending move, as its proxy ID will be reused
+		int proxy = proxies[slot->second];
+		RemovePairs([&](const ProxyPair& pair) { return pair.proxyA == proxy || pair.proxyB == proxy; });
+		moved.erase(std::remove(moved.begin(), moved.end(), proxy), moved.end());
+		tree.DestroyProxy(proxy);
+
+		// Fill the shape's slot with the last shape's
+		int last = proxies.back();
+		proxies[slot->second] = last;
+		slots[tree.GetShape(last)] = slot->second;
+		proxies.pop_back();
+		slots.erase(shape);
+	}
+
+	/* ---- SEARCH FUNCTIONS ---- */
+	// Updates the shapes that have moved, and stores every pair of shapes whose fattened boxes overlap (or reach behind a plane)
+	void FindPairs(std::vector<ShapePair>& pairs)
+	{
+		/* --- MOVE --- */
+
+		// Reinsert the shapes that have left their fattened boxes
+		for (int proxy : proxies)
+		{
+			if (tree.MoveProxy(proxy))
+				moved.push_back(proxy);
+		}
+
+		/* --- NEW PAIRS --- */
+
+		// Only shapes that have moved can have found new neighbours
+		for (int proxy : moved)
+		{
+			glm::vec2 min, max;
+			tree.GetFatBounds(proxy, &min, &max);
+			tree.Query(min, max, [&](Shape*, int other)
+			{
+				if (other == proxy)
+					return true;
+
+				ProxyPair pair = { std::min(proxy, other), std::max(proxy, other) };
+				if (pairKeys.insert(GetKey(pair)).second)
+					proxyPairs.push_back(pair);
+				return true;
+			});
+		}
+		moved.clear();
+
+		/* --- OLD PAIRS --- */
+
+		// Drop pairs whose fattened boxes have moved apart
+		RemovePairs([&](const ProxyPair& pair)
+		{
+			glm::vec2 minA, maxA, minB, maxB;
+			tree.GetFatBounds(pair.proxyA, &minA, &maxA);
+			tree.GetFatBounds(pair.proxyB, &minB, &maxB);
+			return maxA.x < minB.x || maxB.x < minA.x || maxA.y < minB.y || maxB.y < minA.y;
+		});
+
+		/* --- OUTPUT --- */
+
+		pairs.clear();
+		for (const ProxyPair& pair : proxyPairs)
+			pairs.push_back({ tree.GetShape(pair.proxyA), tree.GetShape(pair.proxyB) });
+		for (Shape* plane : planes)
+		{
+			tree.QueryPlane(*(Plane*)plane, [&](Shape* shape, int)
+			{
+				pairs.push_back({ plane, shape });
+				return true;
+			});
+		}
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	const DynamicTree& GetTree() const // Returns the tree holding each bounded shape, for raycasts and region queries
+	{
+		return tree;
+	}
+
+private:
+	// Two proxies whose fattened boxes overlap, with the lower ID first
+	struct ProxyPair
+	{
+		int proxyA;
+		int proxyB;
+	};
+
+	// Returns the key the specified pair is stored under in the set of pairs
+	static long long GetKey(const ProxyPair& pair)
+	{
+		return ((long long)pair.proxyA << 32) | (unsigned int)pair.proxyB;
+	}
+	// Removes every pair the specified function returns true for, keeping the rest in order
+	template<typename Function>
+	void RemovePairs(Function isRemoved)
+	{
+		auto end = std::remove_if(proxyPairs.begin(), proxyPairs.end(), [&](const ProxyPair& pair)
+		{
+			if (!isRemoved(pair))
+				return false;
+			pairKeys.erase(GetKey(pair));
+			return true;
+		});
+		proxyPairs.erase(end, proxyPairs.end());
+	}
+
+	/* ---- VARIABLES ---- */
+	DynamicTree tree;							// The tree holding each bounded shape
+	std::vector<int> proxies;					// The proxy ID of each bounded shape, in the order they were added
+	std::unordered_map<Shape*, int> slots;		// The index of each bounded shape's proxy ID in the list of proxies
+	std::vector<Shape*> planes;					// Each plane, which are kept out of the tree
+	std::vector<int> moved;						// The proxies added or reinserted since pairs were last found
+	std::vector<ProxyPair> proxyPairs;			// Each pair found, in the order they were found
+	std::unordered_set<long long> pairKeys;		// The key of each pair found, to avoid storing a pair twice
+};
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Pathfinder.h"
+
+/* ------------------------------
+BENCHMARK
+
+A small command-line tool that replays a recorded set of path queries
+against the PTV map and reports percentiles of the time and work each
+took, so a change to the Pathfinder can be measured before it goes in.
+Build it alongside Pathfinder.cpp and MappedFile.cpp, then run:
+	Benchmark record <query file> <count>
+		Writes the specified number of random queries between open cells
+	Benchmark <query file> [astar|jps|landmark|bidirectional|anyangle] [map path] [repeats]
+		Replays the queries (5 times by default), using the built-in train
+		network unless a binary map is given
+A query file has one query per line, as grid positions:
+	<start x> <start y> <end x> <end y>
+-------------------------------*/
+
+// A single recorded query, as grid positions
+struct Query
+{
+	int startX;
+	int startY;
+	int endX;
+	int endY;
+};
+
+static const int LANDMARK_COUNT = 16;		// The number of landmarks built for Landmark and Bidirectional searches
+static const int DEFAULT_REPEATS = 5;		// The number of times the queries are replayed when not specified
+static const unsigned int RECORD_SEED = 1;	// The seed used when recording random queries, so recordings can be repeated
+
+// Returns the value at the specified percentile (0 to 100) of the specified values, which must be sorted
+template<typename T>
+T GetPercentile(const std::vector<T>& sorted, double percentile)
+{
+	if (sorted.empty())
+		return T();
+	int rank = (int)((percentile / 100.0) * (sorted.size() - 1) + 0.5);
+	return sorted[rank];
+}
+
+// Prints a row of percentiles and the mean for the specified values
+template<typename T>
+void PrintRow(const char* name, std::vector<T> values)
+{
+	std::sort(values.begin(), values.end());
+	double total = 0.0;
+	for (T value : values)
+		total += (double)value;
+	double mean = values.empty() ? 0.0 : total / values.size();
+
+	printf("%-14s %12.1f %12.1f %12.1f %12.1f %12.1f\n", name, (double)GetPercentile(values, 50), (double)GetPercentile(values, 90),
+		(double)GetPercentile(values, 99), (double)GetPercentile(values, 100), mean);
+}
+
+// Writes the specified number of random queries between open cells to the specified path, returning true if successful
+bool RecordQueries(const Pathfinder& pathfinder, const char* path, int count)
+{
+	const PathGrid& grid = pathfinder.GetGrid();
+	std::mt19937 random(RECORD_SEED);
+	std::uniform_int_distribution<int> randomX(0, grid.GetWidth() - 1);
+	std::uniform_int_distribution<int> randomY(0, grid.GetHeight() - 1);
+
+	FILE* file = fopen(path, "w");
+	if (file == nullptr)
+		return false;
+	for (int i = 0; i < count; i++)
+	{
+		// Only pick open cells, as queries to blocked cells fail straight away and would skew the results
+		Query query;
+		do
+		{
+			query.startX = randomX(random);
+			query.startY = randomY(random);
+			query.endX = randomX(random);
+			query.endY = randomY(random);
+		} while (grid.IsBlocked(grid.GetIndex(query.startX, query.startY)) || grid.IsBlocked(grid.GetIndex(query.endX, query.endY)));
+
+		fprintf(file, "%d %d %d %d\n", query.startX, query.startY, query.endX, query.endY);
+	}
+	return fclose(file) == 0;
+}
+
+// Reads the queries in the specified query file, returning false if it can't be read
+bool ReadQueries(const char* path, std::vector<Query>& queries)
+{
+	FILE* file = fopen(path, "r");
+	if (file == nullptr)
+		return false;
+
+	Query query;
+	while (fscanf(file, "%d %d %d %d", &query.startX, &query.startY, &query.endX, &query.endY) == 4)
+		queries.push_back(query);
+	fclose(file);
+	return true;
+}
+
+// Stores the SearchMode with the specified name, returning false if there is none
+bool ParseMode(const char* name, SearchMode& mode)
+{
+	const char* names[] = { "astar", "jps", "landmark", "bidirectional", "anyangle" };
+	const SearchMode modes[] = { SearchMode::AStar, SearchMode::JumpPoint, SearchMode::Landmark, SearchMode::Bidirectional, SearchMode::AnyAngle };
+	for (int i = 0; i < (int)(sizeof(modes) / sizeof(modes[0])); i++)
+	{
+		if (strcmp(name, names[i]) == 0)
+		{
+			mode = modes[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: %s record <query file> <count>\n", argv[0]);
+		printf("       %s <query file> [astar|jps|landmark|bidirectional|anyangle] [map path] [repeats]\n", argv[0]);
+		return 1;
+	}
+
+	/* --- RECORDING --- */
+
+	if (strcmp(argv[1], "record") == 0)
+	{
+		if (argc != 4)
+		{
+			printf("Usage: %s record <query file> <count>\n", argv[0]);
+			return 1;
+		}
+		Pathfinder pathfinder;
+		if (!RecordQueries(pathfinder, argv[2], atoi(argv[3])))
+		{
+			printf("Could not write queries to '%s'\n", argv[2]);
+			return 1;
+		}
+		printf("Wrote %d queries to '%s'\n", atoi(argv[3]), argv[2]);
+		return 0;
+	}
+
+	/* --- SETUP --- */
+
+	std::vector<Query> queries;
+	if (!ReadQueries(argv[1], queries))
+	{
+		printf("Could not read queries from '%s'\n", argv[1]);
+		return 1;
+	}
+
+	SearchMode mode = SearchMode::AStar;
+	if (argc > 2 && !ParseMode(argv[2], mode))
+	{
+		printf("Unknown search mode '%s'\n", argv[2]);
+		return 1;
+	}
+
+	Pathfinder pathfinder((argc > 3) ? argv[3] : nullptr);
+	if (mode == SearchMode::Landmark || mode == SearchMode::Bidirectional)
+		pathfinder.BuildLandmarks(LANDMARK_COUNT);
+	int repeats = (argc > 4) ? std::max(1, atoi(argv[4])) : DEFAULT_REPEATS;
+
+	// Turn each query into cells, dropping any outside the grid (such as queries recorded on a larger map)
+	const PathGrid& grid = pathfinder.GetGrid();
+	std::vector<int> startCells;
+	std::vector<int> endCells;
+	for (const Query& query : queries)
+	{
+		if (!grid.IsInside(query.startX, query.startY) || !grid.IsInside(query.endX, query.endY))
+			continue;
+		startCells.push_back(grid.GetIndex(query.startX, query.startY));
+		endCells.push_back(grid.GetIndex(query.endX, query.endY));
+	}
+	int count = (int)startCells.size();
+
+	/* --- REPLAY --- */
+
+	// Run every query once to warm up, then time every repeat, keeping the counters from the last (they're the same each time)
+	SearchContext context(grid.GetCellCount());
+	for (int i = 0; i < count; i++)
+		pathfinder.FindPath(startCells[i], endCells[i], context, mode);
+
+	std::vector<double> times;
+	std::vector<int> expanded, pushes, pops, decreases, pathCells;
+	int found = 0;
+	double totalTime = 0.0;
+	times.reserve(count * repeats);
+	for (int repeat = 0; repeat < repeats; repeat++)
+	{
+		bool isLast = repeat == repeats - 1;
+		for (int i = 0; i < count; i++)
+		{
+			bool isFound = pathfinder.FindPath(startCells[i], endCells[i], context, mode);
+			const SearchStats& stats = context.stats;
+			times.push_back(stats.microseconds);
+			totalTime += stats.microseconds;
+			if (!isLast)
+				continue;
+
+			found += isFound ? 1 : 0;
+			expanded.push_back(stats.expanded);
+			pushes.push_back(stats.pushes);
+			pops.push_back(stats.pops);
+			decreases.push_back(stats.decreases);
+			if (isFound)
+				pathCells.push_back(stats.pathCells);
+		}
+	}
+
+	/* --- REPORT --- */
+
+	printf("%d queries (%d skipped as outside the grid), %d found, %d repeats, %.1f ms total\n\n",
+		count, (int)queries.size() - count, found, repeats, totalTime / 1000.0);
+	printf("%-14s %12s %12s %12s %12s %12s\n", "", "p50", "p90", "p99", "max", "mean");
+	PrintRow("microseconds", times);
+	PrintRow("expanded", expanded);
+	PrintRow("pushes", pushes);
+	PrintRow("pops", pops);
+	PrintRow("decreases", decreases);
+	PrintRow("path cells", pathCells);
+	return 0;
+}
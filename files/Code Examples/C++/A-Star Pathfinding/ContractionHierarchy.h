@@ -0,0 +1,626 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "Pathfinder.h"
+#include "MappedFile.h"
+
+/* ------------------------------
+CONTRACTIONHIERARCHY CLASS
+
+The ContractionHierarchy answers repeated queries over a map that doesn't
+change (such as the train network between stations) in a fraction of the
+time of a full search.
+
+Building it ranks every cell by importance, then 'contracts' them from
+least to most important. When a cell is removed, any cheapest path that
+passed through it is kept by adding a shortcut edge between its
+neighbours, remembering the removed cell so the shortcut can be expanded
+again later.
+A query then runs two small Dijkstra searches, forwards from the start
+and backwards from the end, each only following edges to more important
+cells. They meet at the most important cell on the cheapest path, and
+the shortcuts along it are unpacked back into neighbouring cells.
+
+Paths are always the cheapest path (which AStarPath doesn't guarantee
+while the octile heuristic can overestimate the train lines), and match
+the cost of SearchMode::Landmark.
+The hierarchy is built from the grid as it is, and must be rebuilt (or
+reloaded) after any cell is blocked, unblocked or has its costs changed.
+It can be saved to disk so it doesn't need building on every run.
+-------------------------------*/
+
+class ContractionHierarchy
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the ContractionHierarchy over the specified Pathfinder's grid, which must be built or loaded before use
+	ContractionHierarchy(const Pathfinder& pathfinder) : pathfinder(pathfinder), grid(pathfinder.GetGrid())
+	{
+		gridHash = 0;
+		cachedHash = 0;
+		cachedVersion = 0;
+		isHashCached = false;
+	}
+
+	/* ---- BUILD FUNCTIONS ---- */
+	// Contracts every cell of the grid in order of importance, adding shortcuts to keep cheapest paths
+	void Build()
+	{
+		int cellCount = grid.GetCellCount();
+		std::vector<std::vector<BuildEdge>> edgesOut(cellCount);
+		std::vector<std::vector<BuildEdge>> edgesIn(cellCount);
+		std::vector<int> removedNeighbours(cellCount, 0);
+		std::vector<int> depth(cellCount, 0);
+		std::vector<std::vector<Edge>> up(cellCount);
+		std::vector<std::vector<Edge>> down(cellCount);
+		rank.assign(cellCount, -1);
+
+		// Copy the grid's edges (only into unblocked cells, but blocked cells can still be started from)
+		for (int cell = 0; cell < cellCount; cell++)
+		{
+			if (!grid.IsInside(cell))
+				continue;
+			for (int n = 0; n < PathGrid::NEIGHBOURS; n++)
+			{
+				int neighbour = grid.GetNeighbour(cell, n);
+				if (!grid.IsBlocked(neighbour))
+					AddBuildEdge(edgesOut, edgesIn, cell, neighbour, grid.GetCost(cell, n), -1);
+			}
+		}
+
+		// Queue every cell by its importance
+		WitnessSearch witness(cellCount);
+		BasicNodeHeap<int> queue(cellCount);
+		std::vector<Shortcut> shortcuts;
+		for (int cell = 0; cell < cellCount; cell++)
+		{
+			if (grid.IsInside(cell))
+				queue.Push(cell, GetImportance(cell, edgesOut, edgesIn, removedNeighbours, depth, witness, shortcuts));
+		}
+
+		// Contract the least important cell each time, re-checking its importance first as contracting its neighbours will have changed it
+		int nextRank = 0;
+		while (queue.GetCount() > 0)
+		{
+			int cell = queue.GetTop();
+			int importance = GetImportance(cell, edgesOut, edgesIn, removedNeighbours, depth, witness, shortcuts);
+			if (importance > queue.GetTopScore())
+			{
+				queue.UpdateScore(cell, importance);
+				continue;
+			}
+			queue.Pop();
+
+			// Add the shortcuts needed to remove the cell
+			for (const Shortcut& shortcut : shortcuts)
+				AddBuildEdge(edgesOut, edgesIn, shortcut.from, shortcut.to, shortcut.cost, cell);
+			rank[cell] = nextRank++;
+
+			// Every remaining neighbour is more important, so the cell's edges are final and can be kept for queries
+			// Edges into the cell are stored against it for the backward search
+			up[cell] = edgesOut[cell];
+			down[cell] = edgesIn[cell];
+
+			// Remove the cell from the remaining graph
+			for (const BuildEdge& edge : edgesOut[cell])
+				RemoveBuildEdge(edgesIn[edge.node], cell, removedNeighbours[edge.node], depth[edge.node], depth[cell]);
+			for (const BuildEdge& edge : edgesIn[cell])
+				RemoveBuildEdge(edgesOut[edge.node], cell, removedNeighbours[edge.node], depth[edge.node], depth[cell]);
+			std::vector<BuildEdge>().swap(edgesOut[cell]);
+			std::vector<BuildEdge>().swap(edgesIn[cell]);
+		}
+
+		// Pack the edges kept for queries
+		Flatten(up, upFirst, upEdges);
+		Flatten(down, downFirst, downEdges);
+		gridHash = GetGridHash();
+	}
+	// Returns true if the ContractionHierarchy has been built or loaded for the grid as it currently is
+	// The grid's hash is only worked out again after the grid changes, so this shouldn't be called from several threads at once
+	bool IsUpToDate() const
+	{
+		return !rank.empty() && gridHash == GetGridHash();
+	}
+
+	/* ---- FILE FUNCTIONS ---- */
+	// Writes the ContractionHierarchy to the specified path, returning true if successful, otherwise false
+	bool Save(const char* path) const
+	{
+		FileHeader header = {};
+		memcpy(header.magic, "PTVC", 4);
+		header.version = FILE_VERSION;
+		header.cellCount = (int)rank.size();
+		header.upCount = (int)upEdges.size();
+		header.downCount = (int)downEdges.size();
+		header.gridHash = gridHash;
+
+		FILE* file = fopen(path, "wb");
+		if (file == nullptr)
+			return false;
+		bool isWritten =
+			fwrite(&header, sizeof(FileHeader), 1, file) == 1 &&
+			fwrite(rank.data(), sizeof(int), rank.size(), file) == rank.size() &&
+			fwrite(upFirst.data(), sizeof(int), upFirst.size(), file) == upFirst.size() &&
+			fwrite(downFirst.data(), sizeof(int), downFirst.size(), file) == downFirst.size() &&
+			fwrite(upEdges.data(), sizeof(Edge), upEdges.size(), file) == upEdges.size() &&
+			fwrite(downEdges.data(), sizeof(Edge), downEdges.size(), file) == downEdges.size();
+		return (fclose(file) == 0) && isWritten;
+	}
+	// Reads the ContractionHierarchy from the specified path, returning true if successful, otherwise false
+	// Fails if the file was built for a different grid, or for this grid before it last changed
+	bool Load(const char* path)
+	{
+		// Map the file and check the header
+		MappedFile file;
+		FileHeader header;
+		if (!file.Open(path) || file.GetSize() < sizeof(FileHeader))
+			return false;
+		memcpy(&header, file.GetData(), sizeof(FileHeader));
+		if (memcmp(header.magic, "PTVC", 4) != 0 || header.version != FILE_VERSION)
+			return false;
+		if (header.cellCount != grid.GetCellCount() || header.gridHash != GetGridHash() || header.upCount < 0 || header.downCount < 0)
+			return false;
+		size_t cellCount = header.cellCount;
+		size_t expected = sizeof(FileHeader) + (cellCount * sizeof(int)) + (2 * (cellCount + 1) * sizeof(int)) + ((size_t)(header.upCount + header.downCount) * sizeof(Edge));
+		if (file.GetSize() != expected)
+			return false;
+
+		// Read each array in the order they were saved
+		const unsigned char* read = file.GetData() + sizeof(FileHeader);
+		std::vector<int> newRank, newUpFirst, newDownFirst;
+		std::vector<Edge> newUpEdges, newDownEdges;
+		Read(read, newRank, cellCount);
+		Read(read, newUpFirst, cellCount + 1);
+		Read(read, newDownFirst, cellCount + 1);
+		Read(read, newUpEdges, header.upCount);
+		Read(read, newDownEdges, header.downCount);
+
+		// Queries index straight into these arrays, so check every index is in range before replacing anything
+		for (int cellRank : newRank)
+		{
+			if (cellRank < -1 || cellRank >= (int)cellCount)
+				return false;
+		}
+		if (!IsValidEdges(newUpFirst, newUpEdges, (int)cellCount) || !IsValidEdges(newDownFirst, newDownEdges, (int)cellCount))
+			return false;
+
+		// Searches only climb and unpacking only descends, so a file that breaks the order could loop forever
+		if (!IsValidOrder(newUpFirst, newUpEdges, newRank) || !IsValidOrder(newDownFirst, newDownEdges, newRank))
+			return false;
+
+		rank.swap(newRank);
+		upFirst.swap(newUpFirst);
+		downFirst.swap(newDownFirst);
+		upEdges.swap(newUpEdges);
+		downEdges.swap(newDownEdges);
+		gridHash = header.gridHash;
+		return true;
+	}
+
+	/* ---- PATHFINDING FUNCTIONS ---- */
+	// Finds the cheapest path between the two specified world positions, returning true if a path was found, otherwise false
+	bool FindPath(Vector2 start, Vector2 end, List<Vector2>& finalPath, SearchContext& forward, SearchContext& backward) const
+	{
+		// Clear the path, and search between the start and end cells
+		finalPath.Clear();
+		if (!FindPath(pathfinder.GetNodeByPos(start), pathfinder.GetNodeByPos(end), forward, backward))
+			return false;
+
+		// Path has been found, so add it
+		for (int current : forward.path)
+			finalPath.Add(pathfinder.GetPosByNode(current));
+		return true;
+	}
+	// Finds the cheapest path between the two specified cells, returning true if a path was found, otherwise false
+	// Each direction of the search uses its own SearchContext, and when found the path's cells are stored in the forward one
+	bool FindPath(int nodeStart, int nodeEnd, SearchContext& forward, SearchContext& backward) const
+	{
+		/* --- EARLY EXIT --- */
+
+		// Return false if immediately no path is possible
+		forward.path.clear();
+		if (nodeStart == -1 || nodeEnd == -1 || grid.IsBlocked(nodeEnd) || rank.empty())
+			return false;
+
+		// Return true if path ends on itself
+		if (nodeStart == nodeEnd)
+		{
+			forward.path.push_back(nodeEnd);
+			return true;
+		}
+
+		/* --- SEARCH --- */
+
+		// Search upwards from both ends at once, always advancing whichever side has the cheaper cell next
+		StartSearch(nodeStart, forward);
+		StartSearch(nodeEnd, backward);
+		int bestCost = INT_MAX;
+		int meeting = -1;
+		while (true)
+		{
+			// Each side can stop once it can't find anything cheaper than the best path so far
+			bool isForwardOpen = forward.listOpen.GetCount() > 0 && forward.listOpen.GetTopScore() < bestCost;
+			bool isBackwardOpen = backward.listOpen.GetCount() > 0 && backward.listOpen.GetTopScore() < bestCost;
+			if (!isForwardOpen && !isBackwardOpen)
+				break;
+
+			bool isForward = isForwardOpen && (!isBackwardOpen || forward.listOpen.GetTopScore() <= backward.listOpen.GetTopScore());
+			SearchContext& context = isForward ? forward : backward;
+			SearchContext& other = isForward ? backward : forward;
+			int current = context.listOpen.Pop();
+			context.SetClosed(current);
+
+			// Check whether the two sides meet here for less than the best so far
+			if (other.IsVisited(current) && context.scoreG[current] + other.scoreG[current] < bestCost)
+			{
+				bestCost = context.scoreG[current] + other.scoreG[current];
+				meeting = current;
+			}
+
+			// If a more important cell already reached offers a cheaper way here, this cell can't be on the cheapest path, so stop here
+			if (IsStalled(current, context, isForward))
+				continue;
+
+			// Relax the edges to more important cells
+			const std::vector<int>& first = isForward ? upFirst : downFirst;
+			const std::vector<Edge>& edges = isForward ? upEdges : downEdges;
+			for (int i = first[current]; i < first[current + 1]; i++)
+			{
+				int neighbour = edges[i].node;
+				int newG = context.scoreG[current] + edges[i].cost;
+				if (context.IsVisited(neighbour))
+				{
+					if (newG < context.scoreG[neighbour] && !context.IsClosed(neighbour))
+					{
+						context.scoreG[neighbour] = newG;
+						context.prev[neighbour] = current;
+						context.listOpen.DecreaseScore(neighbour, newG);
+					}
+				}
+				else
+				{
+					context.SetVisited(neighbour);
+					context.scoreG[neighbour] = newG;
+					context.prev[neighbour] = current;
+					context.listOpen.Push(neighbour, newG);
+				}
+			}
+		}
+		if (meeting == -1)
+			return false;
+
+		/* --- UNPACKING --- */
+
+		// Collect the edges from the start up to the meeting cell, and from there down to the end
+		std::vector<int> route;
+		for (int current = meeting; current != -1; current = forward.prev[current])
+			route.push_back(current);
+		std::reverse(route.begin(), route.end());
+		for (int current = backward.prev[meeting]; current != -1; current = backward.prev[current])
+			route.push_back(current);
+
+		// Expand every shortcut back into the cells it skips, storing the path from the end back to the start
+		std::vector<std::pair<int, int>> pending;
+		for (int i = (int)route.size() - 1; i > 0; i--)
+		{
+			pending.push_back({ route[i - 1], route[i] });
+			while (!pending.empty())
+			{
+				std::pair<int, int> step = pending.back();
+				pending.pop_back();
+				const Edge* edge = FindEdge(step.first, step.second);
+				if (edge == nullptr)
+				{
+					forward.path.clear();
+					return false;
+				}
+				int middle = edge->middle;
+				if (middle == -1)
+				{
+					forward.path.push_back(step.second);
+					continue;
+				}
+
+				// Unpack the later half first, as the path is stored backwards
+				pending.push_back({ step.first, middle });
+				pending.push_back({ middle, step.second });
+			}
+		}
+		forward.path.push_back(nodeStart);
+		return true;
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	int GetShortcutCount() const // Returns the number of edges in the hierarchy, including shortcuts
+	{
+		return (int)(upEdges.size() + downEdges.size());
+	}
+
+	/* ---- CONSTANTS ---- */
+	static const unsigned int FILE_VERSION = 1;		// The file format version, raised whenever the layout changes
+	static const int WITNESS_LIMIT = 500;			// The most cells a witness search settles before assuming a shortcut is needed
+
+private:
+	/* ---- NESTED CLASSES/STRUCTS ---- */
+	struct Edge
+	{
+		int node;			// The cell at the other end of the edge
+		int cost;			// The cost of the edge
+		int middle;			// The cell contracted to create this shortcut, or -1 if it is an edge of the grid
+	};
+	typedef Edge BuildEdge;
+	struct Shortcut
+	{
+		int from;			// The cell the shortcut starts at
+		int to;				// The cell the shortcut ends at
+		int cost;			// The cost of the shortcut
+	};
+	struct FileHeader
+	{
+		char magic[4];					// Always "PTVC"
+		unsigned int version;			// The format version, which must match FILE_VERSION
+		int cellCount;					// The number of cells in the grid
+		int upCount;					// The number of upward edges
+		int downCount;					// The number of downward edges
+		unsigned int gridHash;			// The hash of the grid the hierarchy was built for
+	};
+	// The scratch state of the local searches used while building
+	struct WitnessSearch
+	{
+		WitnessSearch(int cellCount) : listOpen(cellCount), costs(cellCount, 0), stamps(cellCount, 0), targetStamps(cellCount, 0)
+		{
+			searchId = 0;
+			targetCount = 0;
+		}
+
+		NodeHeap listOpen;						// The open list
+		std::vector<int> costs;					// The cost to each cell reached
+		std::vector<unsigned int> stamps;		// The last search that reached each cell
+		std::vector<unsigned int> targetStamps;	// The last search that needed the cost to each cell
+		unsigned int searchId;					// The ID of the current search
+		int targetCount;						// The number of target cells not yet settled
+	};
+
+	/* ---- BUILD FUNCTIONS ---- */
+	// Returns how important the specified cell is (lower is contracted sooner), storing the shortcuts contracting it would need
+	int GetImportance(int cell, const std::vector<std::vector<BuildEdge>>& edgesOut, const std::vector<std::vector<BuildEdge>>& edgesIn,
+		const std::vector<int>& removedNeighbours, const std::vector<int>& depth, WitnessSearch& witness, std::vector<Shortcut>& shortcuts) const
+	{
+		shortcuts.clear();
+		for (const BuildEdge& in : edgesIn[cell])
+		{
+			// Find the most a shortcut from this cell could cost, then look for cheaper ways around the contracted cell
+			int maxCost = 0;
+			witness.searchId++;
+			witness.targetCount = 0;
+			for (const BuildEdge& out : edgesOut[cell])
+			{
+				if (out.node == in.node)
+					continue;
+				maxCost = std::max(maxCost, in.cost + out.cost);
+				witness.targetStamps[out.node] = witness.searchId;
+				witness.targetCount++;
+			}
+			FindWitnesses(in.node, cell, maxCost, edgesOut, witness);
+
+			// A shortcut is needed wherever going through the cell is still cheapest
+			for (const BuildEdge& out : edgesOut[cell])
+			{
+				if (out.node == in.node)
+					continue;
+				int cost = in.cost + out.cost;
+				if (witness.stamps[out.node] != witness.searchId || witness.costs[out.node] > cost)
+					shortcuts.push_back({ in.node, out.node, cost });
+			}
+		}
+		int edgeCount = (int)(edgesIn[cell].size() + edgesOut[cell].size());
+
+		// Prefer cells that add fewer edges than they remove, and spread contraction out so the hierarchy stays shallow
+		return (2 * ((int)shortcuts.size() - edgeCount)) + removedNeighbours[cell] + depth[cell];
+	}
+	// Finds the cost from the specified cell to the targets marked in the WitnessSearch without passing through the skipped cell, up to the specified cost
+	void FindWitnesses(int source, int skipped, int maxCost, const std::vector<std::vector<BuildEdge>>& edgesOut, WitnessSearch& witness) const
+	{
+		witness.listOpen.Clear();
+		witness.stamps[source] = witness.searchId;
+		witness.costs[source] = 0;
+		witness.listOpen.Push(source, 0);
+
+		int settled = 0;
+		while (witness.listOpen.GetCount() > 0 && settled < WITNESS_LIMIT)
+		{
+			if (witness.listOpen.GetTopScore() > maxCost)
+				break;
+			int current = witness.listOpen.Pop();
+			settled++;
+
+			// Stop once the cost to every cell a shortcut might lead to is known
+			if (witness.targetStamps[current] == witness.searchId && --witness.targetCount == 0)
+				break;
+
+			for (const BuildEdge& edge : edgesOut[current])
+			{
+				if (edge.node == skipped)
+					continue;
+
+				int cost = witness.costs[current] + edge.cost;
+				if (witness.stamps[edge.node] != witness.searchId)
+				{
+					witness.stamps[edge.node] = witness.searchId;
+					witness.costs[edge.node] = cost;
+					witness.listOpen.Push(edge.node, cost);
+				}
+				else if (cost < witness.costs[edge.node] && witness.listOpen.Contains(edge.node))
+				{
+					witness.costs[edge.node] = cost;
+					witness.listOpen.DecreaseScore(edge.node, cost);
+				}
+			}
+		}
+	}
+	// Adds an edge between the specified cells, or lowers the cost of the existing one if this is cheaper
+	static void AddBuildEdge(std::vector<std::vector<BuildEdge>>& edgesOut, std::vector<std::vector<BuildEdge>>& edgesIn, int from, int to, int cost, int middle)
+	{
+		for (BuildEdge& edge : edgesOut[from])
+		{
+			if (edge.node != to)
+				continue;
+			if (cost < edge.cost)
+			{
+				edge = { to, cost, middle };
+				for (BuildEdge& reverse : edgesIn[to])
+				{
+					if (reverse.node == from)
+						reverse = { from, cost, middle };
+				}
+			}
+			return;
+		}
+		edgesOut[from].push_back({ to, cost, middle });
+		edgesIn[to].push_back({ from, cost, middle });
+	}
+	// Removes the edge to or from the specified contracted cell from a remaining neighbour's edge list, and updates the neighbour's importance terms
+	static void RemoveBuildEdge(std::vector<BuildEdge>& edges, int contracted, int& removedNeighbours, int& depth, int contractedDepth)
+	{
+		for (int i = 0; i < (int)edges.size(); i++)
+		{
+			if (edges[i].node != contracted)
+				continue;
+			edges[i] = edges.back();
+			edges.pop_back();
+			break;
+		}
+		removedNeighbours++;
+		depth = std::max(depth, contractedDepth + 1);
+	}
+	// Packs per-cell edge lists into one array, with each cell's edges starting at its entry in the first array
+	static void Flatten(const std::vector<std::vector<Edge>>& lists, std::vector<int>& first, std::vector<Edge>& edges)
+	{
+		first.assign(lists.size() + 1, 0);
+		edges.clear();
+		for (int cell = 0; cell < (int)lists.size(); cell++)
+		{
+			first[cell] = (int)edges.size();
+			edges.insert(edges.end(), lists[cell].begin(), lists[cell].end());
+		}
+		first[lists.size()] = (int)edges.size();
+	}
+
+	/* ---- MISC. FUNCTIONS ---- */
+	// Clears the specified SearchContext and adds the specified cell to its open list
+	static void StartSearch(int node, SearchContext& context)
+	{
+		context.BeginSearch();
+		context.SetVisited(node);
+		context.scoreG[node] = 0;
+		context.prev[node] = -1;
+		context.listOpen.Push(node, 0);
+	}
+	// Returns true if the specified cell can be reached more cheaply through a more important cell the search has already scored
+	bool IsStalled(int node, const SearchContext& context, bool isForward) const
+	{
+		// Edges from more important cells into this one are the opposite direction's edges
+		const std::vector<int>& first = isForward ? downFirst : upFirst;
+		const std::vector<Edge>& edges = isForward ? downEdges : upEdges;
+		for (int i = first[node]; i < first[node + 1]; i++)
+		{
+			int other = edges[i].node;
+			if (context.IsVisited(other) && context.scoreG[other] + edges[i].cost < context.scoreG[node])
+				return true;
+		}
+		return false;
+	}
+	// Returns the edge from the first specified cell to the second, which is stored against whichever is less important, or nullptr if there is none
+	const Edge* FindEdge(int from, int to) const
+	{
+		bool isUp = rank[to] > rank[from];
+		const std::vector<int>& first = isUp ? upFirst : downFirst;
+		const std::vector<Edge>& edges = isUp ? upEdges : downEdges;
+		int owner = isUp ? from : to;
+		int other = isUp ? to : from;
+		for (int i = first[owner]; i < first[owner + 1]; i++)
+		{
+			if (edges[i].node == other)
+				return &edges[i];
+		}
+		return nullptr;
+	}
+	// Returns a hash of the grid's binary map, used to tell whether the hierarchy was built for it as it currently is
+	// The hash is kept until the grid's version changes, as working it out means saving the whole grid
+	unsigned int GetGridHash() const
+	{
+		if (isHashCached && cachedVersion == grid.GetVersion())
+			return cachedHash;
+
+		std::vector<unsigned char> data;
+		grid.Save(data);
+
+		// FNV-1a
+		unsigned int hash = 2166136261u;
+		for (unsigned char byte : data)
+			hash = (hash ^ byte) * 16777619u;
+
+		cachedHash = hash;
+		cachedVersion = grid.GetVersion();
+		isHashCached = true;
+		return hash;
+	}
+	// Returns true if the specified first edge of each cell runs in order from 0 to the number of edges, and every edge's cells are in the grid
+	static bool IsValidEdges(const std::vector<int>& first, const std::vector<Edge>& edges, int cellCount)
+	{
+		if (first.front() != 0 || first.back() != (int)edges.size())
+			return false;
+		for (size_t i = 1; i < first.size(); i++)
+		{
+			if (first[i] < first[i - 1])
+				return false;
+		}
+		for (const Edge& edge : edges)
+		{
+			if (edge.node < 0 || edge.node >= cellCount || edge.middle < -1 || edge.middle >= cellCount)
+				return false;
+		}
+		return true;
+	}
+	// Returns true if every edge stored against a cell leads to a more important cell, and every shortcut's middle cell is less important than both its ends
+	static bool IsValidOrder(const std::vector<int>& first, const std::vector<Edge>& edges, const std::vector<int>& rank)
+	{
+		for (int cell = 0; cell < (int)rank.size(); cell++)
+		{
+			for (int i = first[cell]; i < first[cell + 1]; i++)
+			{
+				// Border cells (ranked -1) are never contracted, so have no edges and are never the end of one
+				const Edge& edge = edges[i];
+				if (rank[cell] == -1 || rank[edge.node] <= rank[cell])
+					return false;
+				if (edge.middle != -1 && (rank[edge.middle] == -1 || rank[edge.middle] >= rank[cell]))
+					return false;
+			}
+		}
+		return true;
+	}
+	// Copies the specified number of values from the specified position into the specified array, then moves past them
+	template<typename T>
+	static void Read(const unsigned char*& read, std::vector<T>& values, size_t count)
+	{
+		values.resize(count);
+		memcpy(values.data(), read, count * sizeof(T));
+		read += count * sizeof(T);
+	}
+
+	/* ---- VARIABLES ---- */
+	const Pathfinder& pathfinder;		// The Pathfinder whose grid the hierarchy is built from
+	const PathGrid& grid;				// The Pathfinder's grid
+	std::vector<int> rank;				// The order each cell was contracted in, or -1 for border cells
+	std::vector<int> upFirst;			// The first upward edge of each cell (and one past the last cell's)
+	std::vector<Edge> upEdges;			// The edges from each cell to more important cells
+	std::vector<int> downFirst;			// The first downward edge into each cell (and one past the last cell's)
+	std::vector<Edge> downEdges;		// The edges into each cell from more important cells, stored from the other cell
+	unsigned int gridHash;				// The hash of the grid the hierarchy was built for
+	mutable unsigned int cachedHash;	// The hash of the grid when GetGridHash last worked it out
+	mutable unsigned int cachedVersion;	// The grid's version when GetGridHash last worked out its hash
+	mutable bool isHashCached;			// Whether GetGridHash has worked out a hash yet
+};
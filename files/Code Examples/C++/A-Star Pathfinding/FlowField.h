@@ -0,0 +1,229 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <vector>
+#include "Pathfinder.h"
+#include "ThreadPool.h"
+
+/* ------------------------------
+FLOWFIELD CLASS
+
+The FlowField guides any number of agents to one end cell, such as a
+crowd converging on a station, without a search per agent.
+It finds the cheapest cost from every cell to the end with one search
+outwards from the end, then stores for each cell the neighbour to move
+to next. An agent follows the field by looking up its current cell.
+
+The search runs in wavefronts, spread across a ThreadPool. Every edge
+costs at least the grid's cheapest edge, so all cells whose cost is
+within one cheapest edge of the lowest unfinished cost are already
+final, and can be expanded at the same time. Each worker expands part of
+the wavefront into its own list of proposed costs, and the lists are
+then merged in a fixed order, so the result is the same however the
+work was shared out.
+
+The field is kept until the map changes (see Update), so it can be
+reused every tick.
+-------------------------------*/
+
+class FlowField
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes an empty FlowField over the specified Pathfinder's grid, with the specified number of workers (or one per core if 0)
+	FlowField(const Pathfinder& pathfinder, int workerCount = 0) :
+		pathfinder(pathfinder),
+		grid(pathfinder.GetGrid()),
+		pool(workerCount),
+		proposals(pool.GetWorkerCount() * TASKS_PER_WORKER)
+	{
+		nodeEnd = -1;
+		version = 0;
+	}
+
+	/* ---- BUILD FUNCTIONS ---- */
+	// Finds the cheapest cost and next step from every cell to the specified end cell
+	void Build(int nodeEnd)
+	{
+		this->nodeEnd = nodeEnd;
+		version = grid.GetVersion();
+		int cellCount = grid.GetCellCount();
+		costs.assign(cellCount, (int)INFINITE);
+		directions.assign(cellCount, -1);
+		if (nodeEnd == -1 || grid.IsBlocked(nodeEnd))
+			return;
+
+		/* --- INTEGRATION --- */
+
+		// Cells are bucketed by cost, with buckets one cheapest edge wide, so every cell in the lowest bucket is final
+		int width = grid.GetMinCost();
+		assert(width > 0 && "Wavefronts need every edge to have a cost");
+		std::vector<std::vector<int>> buckets(1, std::vector<int>(1, nodeEnd));
+		std::vector<bool> isFinal(cellCount, false);
+		std::vector<int> wave;
+		costs[nodeEnd] = 0;
+		for (int bucket = 0; bucket < (int)buckets.size(); bucket++)
+		{
+			// Collect the wavefront, skipping cells that were re-bucketed at a lower cost or already expanded
+			wave.clear();
+			for (int cell : buckets[bucket])
+			{
+				if (!isFinal[cell] && costs[cell] / width == bucket)
+				{
+					isFinal[cell] = true;
+					wave.push_back(cell);
+				}
+			}
+			std::vector<int>().swap(buckets[bucket]);
+			if (wave.empty())
+				continue;
+
+			// Expand the wavefront in parallel, each task proposing costs for the cells that lead into its part of it
+			int taskCount = std::min((int)proposals.size(), ((int)wave.size() + MIN_CELLS_PER_TASK - 1) / MIN_CELLS_PER_TASK);
+			pool.Run(taskCount, [&](int task, int worker)
+			{
+				int first = (int)(((long long)wave.size() * task) / taskCount);
+				int last = (int)(((long long)wave.size() * (task + 1)) / taskCount);
+				Expand(wave, first, last, isFinal, proposals[task]);
+			});
+
+			// Merge the proposals in task order, bucketing any cell whose cost dropped
+			for (int task = 0; task < taskCount; task++)
+			{
+				for (const Proposal& proposal : proposals[task])
+				{
+					if (proposal.cost >= costs[proposal.cell])
+						continue;
+					costs[proposal.cell] = proposal.cost;
+					int target = proposal.cost / width;
+					if (target >= (int)buckets.size())
+						buckets.resize(target + 1);
+					buckets[target].push_back(proposal.cell);
+				}
+			}
+		}
+
+		/* --- DIRECTIONS --- */
+
+		// Point every cell at its cheapest neighbour, in parallel as each cell only reads the finished costs
+		int taskCount = pool.GetWorkerCount() * TASKS_PER_WORKER;
+		pool.Run(taskCount, [&](int task, int worker)
+		{
+			int first = (int)(((long long)cellCount * task) / taskCount);
+			int last = (int)(((long long)cellCount * (task + 1)) / taskCount);
+			for (int cell = first; cell < last; cell++)
+				directions[cell] = (signed char)GetBestDirection(cell);
+		});
+	}
+	// Rebuilds the FlowField for the same end cell if the map has changed since it was built, returning true if it was rebuilt
+	bool Update()
+	{
+		if (IsUpToDate())
+			return false;
+		Build(nodeEnd);
+		return true;
+	}
+	// Returns true if the map hasn't changed since the FlowField was built
+	bool IsUpToDate() const
+	{
+		return version == grid.GetVersion() && !costs.empty();
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	// Returns the next cell to move to from the specified cell, or -1 if it is the end or can't reach it
+	int GetNextNode(int node) const
+	{
+		if (node == -1 || directions[node] == -1)
+			return -1;
+		return grid.GetNeighbour(node, directions[node]);
+	}
+	// As above, but returns the world position of the next cell from the specified world position, or the position itself if there is none
+	Vector2 GetNextPos(Vector2 pos) const
+	{
+		int next = GetNextNode(pathfinder.GetNodeByPos(pos));
+		return (next == -1) ? pos : pathfinder.GetPosByNode(next);
+	}
+	int GetDirection(int node) const // Returns the neighbour index to move towards from the specified cell, or -1 if there is none
+	{
+		return directions[node];
+	}
+	int GetCost(int node) const // Returns the cheapest cost from the specified cell to the end, or INFINITE if it can't reach it
+	{
+		return costs[node];
+	}
+	int GetEnd() const // Returns the end cell the FlowField leads to
+	{
+		return nodeEnd;
+	}
+
+	/* ---- CONSTANTS ---- */
+	static const int INFINITE = INT_MAX;			// The cost of a cell that can't reach the end
+	static const int TASKS_PER_WORKER = 4;			// How many parts each worker's share of a wavefront is split into, so idle workers can steal
+	static const int MIN_CELLS_PER_TASK = 64;		// The fewest wavefront cells worth running as a separate task
+
+private:
+	/* ---- NESTED CLASSES/STRUCTS ---- */
+	struct Proposal
+	{
+		int cell;			// The cell that could reach the end more cheaply
+		int cost;			// Its new cost
+	};
+
+	// Proposes costs for every unfinished cell with an edge into the specified range of the wavefront
+	void Expand(const std::vector<int>& wave, int first, int last, const std::vector<bool>& isFinal, std::vector<Proposal>& out) const
+	{
+		out.clear();
+		for (int i = first; i < last; i++)
+		{
+			// Paths can't pass through blocked cells, but agents standing on one can still leave it
+			int current = wave[i];
+			if (grid.IsBlocked(current))
+				continue;
+
+			for (int n = 0; n < PathGrid::NEIGHBOURS; n++)
+			{
+				int neighbour = grid.GetNeighbour(current, n);
+				if (!grid.IsInside(neighbour) || isFinal[neighbour])
+					continue;
+
+				// The edge runs from the neighbour back to the current cell
+				int cost = costs[current] + grid.GetCost(neighbour, (n + 4) % PathGrid::NEIGHBOURS);
+				if (cost < costs[neighbour])
+					out.push_back({ neighbour, cost });
+			}
+		}
+	}
+	// Returns the neighbour index of the specified cell's cheapest step towards the end, or -1 if there is none
+	int GetBestDirection(int cell) const
+	{
+		if (cell == nodeEnd || costs[cell] == INFINITE)
+			return -1;
+
+		int best = -1;
+		long long bestCost = LLONG_MAX;
+		for (int n = 0; n < PathGrid::NEIGHBOURS; n++)
+		{
+			int neighbour = grid.GetNeighbour(cell, n);
+			if (grid.IsBlocked(neighbour) || costs[neighbour] == INFINITE)
+				continue;
+
+			long long cost = (long long)grid.GetCost(cell, n) + costs[neighbour];
+			if (cost < bestCost)
+			{
+				best = n;
+				bestCost = cost;
+			}
+		}
+		return best;
+	}
+
+	/* ---- VARIABLES ---- */
+	const Pathfinder& pathfinder;						// The Pathfinder whose grid the FlowField covers
+	const PathGrid& grid;								// The Pathfinder's grid
+	ThreadPool pool;									// The workers wavefronts are spread across
+	std::vector<std::vector<Proposal>> proposals;		// The costs proposed by each task of the current wavefront
+	std::vector<int> costs;								// The cheapest cost from each cell to the end
+	std::vector<signed char> directions;				// The neighbour index to move to from each cell, or -1
+	int nodeEnd;										// The end cell the FlowField leads to
+	unsigned int version;								// The grid's version when the FlowField was built
+};
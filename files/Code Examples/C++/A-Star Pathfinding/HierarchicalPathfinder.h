@@ -0,0 +1,440 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "Pathfinder.h"
+
+/* ------------------------------
+HIERARCHICALPATHFINDER CLASS
+
+The HierarchicalPathfinder speeds up long queries on a Pathfinder's grid
+using HPA* (Hierarchical Path-Finding A*).
+
+The grid is split into square clusters. Where two neighbouring clusters
+share an open stretch of border, one or two pairs of cells across it
+become entrances, linked to each other. The cost between every pair of
+entrances inside a cluster is precomputed and cached.
+A query first searches this much smaller graph of entrances, then
+refines each step of the result into cells, only searching inside one
+cluster at a time.
+
+Paths are close to, but not always exactly, the cheapest path.
+When a cell is blocked or its costs change, only its cluster (and the
+neighbouring clusters, if the cell is on a border) are rebuilt.
+Each change to the grid must be reported once (see OnNodeChanged), which
+is counted against the grid's version. If the map changes without being
+reported, such as through Pathfinder::SetBlocked or loading a new map,
+queries fail until the clusters are rebuilt with Update.
+-------------------------------*/
+
+class HierarchicalPathfinder
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the HierarchicalPathfinder over the specified Pathfinder's grid, with clusters of the specified size
+	HierarchicalPathfinder(Pathfinder& pathfinder, int clusterSize = 16) :
+		pathfinder(pathfinder),
+		grid(pathfinder.GetGrid()),
+		buildContext(pathfinder.GetGrid().GetCellCount())
+	{
+		this->clusterSize = clusterSize;
+		Build();
+	}
+
+	/* ---- PATHFINDING FUNCTIONS ---- */
+	// Finds a path between the two specified world positions, returning true if a path was found, otherwise false
+	bool FindPath(Vector2 start, Vector2 end, List<Vector2>& finalPath, SearchContext& context) const
+	{
+		// Clear the path, and search between the start and end cells
+		finalPath.Clear();
+		if (!FindPath(pathfinder.GetNodeByPos(start), pathfinder.GetNodeByPos(end), context))
+			return false;
+
+		// Path has been found, so add it
+		for (int current : context.path)
+			finalPath.Add(pathfinder.GetPosByNode(current));
+		return true;
+	}
+	// Finds a path between the two specified cells, returning true if a path was found, otherwise false
+	// When found, the path's cells are stored in the SearchContext
+	bool FindPath(int nodeStart, int nodeEnd, SearchContext& context) const
+	{
+		/* --- EARLY EXIT --- */
+
+		// Return false if immediately no path is possible, or the clusters are out of date
+		context.path.clear();
+		if (!IsUpToDate() || nodeStart == -1 || nodeEnd == -1 || grid.IsBlocked(nodeEnd))
+			return false;
+
+		// Short queries inside one cluster gain nothing from the abstraction, so search the grid directly
+		int clusterStart = GetCluster(nodeStart);
+		int clusterEnd = GetCluster(nodeEnd);
+		if (clusterStart == clusterEnd)
+			return pathfinder.FindPath(nodeStart, nodeEnd, context);
+
+		/* --- CONNECT START & END --- */
+
+		// Find the cost from the start to each entrance of its cluster, and from each entrance of the end's cluster to the end
+		std::vector<int> startCosts;
+		std::vector<int> endCosts;
+		SearchCluster(nodeStart, -1, clusterStart, false, context);
+		for (int node : clusters[clusterStart].nodes)
+			startCosts.push_back(context.IsClosed(node) ? context.scoreG[node] : -1);
+		SearchCluster(nodeEnd, -1, clusterEnd, true, context);
+		for (int node : clusters[clusterEnd].nodes)
+			endCosts.push_back(context.IsClosed(node) ? context.scoreG[node] : -1);
+
+		/* --- ABSTRACT SEARCH --- */
+
+		// Perform A* over the entrances, with the start and end added
+		context.BeginSearch();
+		context.SetVisited(nodeStart);
+		context.scoreG[nodeStart] = 0;
+		context.prev[nodeStart] = -1;
+		context.listOpen.Push(nodeStart, 0);
+
+		bool found = false;
+		while (context.listOpen.GetCount() > 0)
+		{
+			// Remove current entrance from top of list and add to closed list
+			int current = context.listOpen.Pop();
+			context.SetClosed(current);
+			if (current == nodeEnd)
+			{
+				found = true;
+				break;
+			}
+
+			int scoreG = context.scoreG[current];
+			int clusterIndex = GetCluster(current);
+			const Cluster& cluster = clusters[clusterIndex];
+			int local = localIndex[current];
+			int nodeCount = (int)cluster.nodes.size();
+
+			// The start connects to the entrances of its cluster
+			if (current == nodeStart)
+			{
+				for (int i = 0; i < nodeCount; i++)
+				{
+					if (startCosts[i] >= 0 && cluster.nodes[i] != current)
+						Relax(current, cluster.nodes[i], scoreG + startCosts[i], nodeEnd, context);
+				}
+			}
+
+			// Entrances connect to the other entrances of their cluster, and across the border to the neighbouring cluster
+			if (local != -1)
+			{
+				if (current != nodeStart)
+				{
+					for (int i = 0; i < nodeCount; i++)
+					{
+						int cost = cluster.costs[(local * nodeCount) + i];
+						if (cost >= 0 && i != local)
+							Relax(current, cluster.nodes[i], scoreG + cost, nodeEnd, context);
+					}
+				}
+				for (const Link& link : cluster.links[local])
+				{
+					if (!grid.IsBlocked(link.node))
+						Relax(current, link.node, scoreG + link.cost, nodeEnd, context);
+				}
+
+				// Entrances of the end's cluster connect to the end
+				if (clusterIndex == clusterEnd && endCosts[local] >= 0)
+					Relax(current, nodeEnd, scoreG + endCosts[local], nodeEnd, context);
+			}
+		}
+		if (!found)
+			return false;
+
+		/* --- REFINEMENT --- */
+
+		// Store the abstract path, ordered from the end back to the start
+		std::vector<int> waypoints;
+		for (int current = nodeEnd; current != -1; current = context.prev[current])
+			waypoints.push_back(current);
+
+		// Refine each step into cells, searching inside the cluster where both ends share one
+		context.path.push_back(nodeEnd);
+		for (int i = 0; i + 1 < (int)waypoints.size(); i++)
+		{
+			int from = waypoints[i + 1];
+			int to = waypoints[i];
+			int clusterIndex = GetCluster(from);
+
+			// Steps across a border are always to a neighbouring cell
+			if (clusterIndex != GetCluster(to))
+			{
+				context.path.push_back(from);
+				continue;
+			}
+
+			// Steps inside a cluster are searched, and added walking back from the destination
+			if (!SearchCluster(from, to, clusterIndex, false, context))
+			{
+				context.path.clear();
+				return false;
+			}
+			for (int current = context.prev[to]; current != -1; current = context.prev[current])
+				context.path.push_back(current);
+		}
+		return true;
+	}
+
+	/* ---- MAP FUNCTIONS ---- */
+	// Sets whether the cell at the specified world position can be traversed, and updates the clusters it affects
+	void SetBlocked(Vector2 pos, bool isBlocked)
+	{
+		pathfinder.SetBlocked(pos, isBlocked);
+
+		int node = pathfinder.GetNodeByPos(pos);
+		if (node != -1)
+			OnNodeChanged(node);
+	}
+	// Rebuilds the clusters affected by a change to the specified cell's blocked flag or costs
+	// This must be called once for each change made to the grid (each SetNode, SetCost or SetBlocked), as each raises its version by one
+	void OnNodeChanged(int node)
+	{
+		// Only border cells affect the entrances shared with neighbouring clusters
+		int x = grid.GetX(node);
+		int y = grid.GetY(node);
+		int clusterX = x / clusterSize;
+		int clusterY = y / clusterSize;
+		RebuildCluster(GetCluster(node));
+		if (x % clusterSize == 0 && clusterX > 0)
+			RebuildCluster(GetCluster(node) - 1);
+		if (x % clusterSize == clusterSize - 1 && clusterX + 1 < clustersX)
+			RebuildCluster(GetCluster(node) + 1);
+		if (y % clusterSize == 0 && clusterY > 0)
+			RebuildCluster(GetCluster(node) - clustersX);
+		if (y % clusterSize == clusterSize - 1 && clusterY + 1 < clustersY)
+			RebuildCluster(GetCluster(node) + clustersX);
+
+		// Count the change as reported, which only brings the clusters up to date if every other change was too
+		if (version != grid.GetVersion())
+			version++;
+	}
+	// Rebuilds every cluster if the map has changed without being reported, returning true if they were rebuilt
+	bool Update()
+	{
+		if (IsUpToDate())
+			return false;
+		Build();
+		return true;
+	}
+	// Returns true if every change to the map since the clusters were built has been reported
+	bool IsUpToDate() const
+	{
+		return version == grid.GetVersion();
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	// Returns the index of the cluster containing the specified cell
+	int GetCluster(int node) const
+	{
+		return (grid.GetX(node) / clusterSize) + ((grid.GetY(node) / clusterSize) * clustersX);
+	}
+	int GetClusterCount() const // Returns the number of clusters
+	{
+		return (int)clusters.size();
+	}
+
+	/* ---- CONSTANTS ---- */
+	static const int LONG_ENTRANCE = 6;		// Open stretches of border at least this long get an entrance at each end, rather than one in the middle
+
+private:
+	/* ---- NESTED CLASSES/STRUCTS ---- */
+	struct Link
+	{
+		int node;							// The entrance cell across the border
+		int cost;							// The cost of stepping to it
+	};
+	struct Cluster
+	{
+		std::vector<int> nodes;				// The entrance cells of the cluster
+		std::vector<int> costs;				// The cost between each pair of entrances (from * count + to), or -1 if unreachable inside the cluster
+		std::vector<std::vector<Link>> links;	// The links from each entrance across the border
+	};
+
+	/* ---- BUILD FUNCTIONS ---- */
+	// Splits the grid into clusters, and finds the entrances and costs of every one
+	void Build()
+	{
+		// The grid may have been resized by loading a new map
+		clustersX = (grid.GetWidth() + clusterSize - 1) / clusterSize;
+		clustersY = (grid.GetHeight() + clusterSize - 1) / clusterSize;
+		clusters.assign(clustersX * clustersY, Cluster());
+		localIndex.assign(grid.GetCellCount(), -1);
+		if ((int)buildContext.scoreG.size() != grid.GetCellCount())
+			buildContext = SearchContext(grid.GetCellCount());
+		version = grid.GetVersion();
+
+		for (int cluster = 0; cluster < (int)clusters.size(); cluster++)
+			RebuildCluster(cluster);
+	}
+	// Finds the entrances of the specified cluster and the costs between them
+	void RebuildCluster(int clusterIndex)
+	{
+		Cluster& cluster = clusters[clusterIndex];
+		for (int node : cluster.nodes)
+			localIndex[node] = -1;
+		cluster.nodes.clear();
+		cluster.links.clear();
+
+		// Find the entrances along each border shared with another cluster
+		// Transitions only depend on the cells either side of a border, so both clusters always agree on them
+		int x0, y0, x1, y1;
+		GetBounds(clusterIndex, x0, y0, x1, y1);
+		int clusterX = clusterIndex % clustersX;
+		int clusterY = clusterIndex / clustersX;
+		if (clusterX + 1 < clustersX)	AddEntrances(cluster, x1, y0, 0, 1, y1 - y0 + 1, 3);		// Right
+		if (clusterX > 0)				AddEntrances(cluster, x0, y0, 0, 1, y1 - y0 + 1, 7);		// Left
+		if (clusterY + 1 < clustersY)	AddEntrances(cluster, x0, y1, 1, 0, x1 - x0 + 1, 1);		// Top
+		if (clusterY > 0)				AddEntrances(cluster, x0, y0, 1, 0, x1 - x0 + 1, 5);		// Bottom
+
+		// Find the cost between each pair of entrances, searching only inside the cluster
+		int nodeCount = (int)cluster.nodes.size();
+		cluster.costs.assign(nodeCount * nodeCount, -1);
+		for (int from = 0; from < nodeCount; from++)
+		{
+			SearchCluster(cluster.nodes[from], -1, clusterIndex, false, buildContext);
+			for (int to = 0; to < nodeCount; to++)
+			{
+				if (buildContext.IsClosed(cluster.nodes[to]))
+					cluster.costs[(from * nodeCount) + to] = buildContext.scoreG[cluster.nodes[to]];
+			}
+		}
+	}
+	// Adds entrances for each open stretch along the specified border, linking them across it in the specified direction
+	// A stretch also ends where the cost of crossing changes, so that train lines crossing a border always get their own entrance
+	void AddEntrances(Cluster& cluster, int startX, int startY, int stepX, int stepY, int length, int direction)
+	{
+		int runStart = -1;
+		int runCost = 0;
+		for (int i = 0; i <= length; i++)
+		{
+			// A border position is open if the cells either side are both unblocked
+			bool isOpen = false;
+			int crossCost = 0;
+			if (i < length)
+			{
+				int node = grid.GetIndex(startX + (i * stepX), startY + (i * stepY));
+				int neighbour = grid.GetNeighbour(node, direction);
+				isOpen = !grid.IsBlocked(node) && !grid.IsBlocked(neighbour);
+				crossCost = grid.GetCost(node, direction) + grid.GetCost(neighbour, (direction + 4) % NEIGHBOUR_COUNT);
+			}
+
+			// Add the entrances of the current stretch once it ends
+			if (runStart != -1 && (!isOpen || crossCost != runCost))
+			{
+				int runEnd = i - 1;
+				if (runEnd - runStart + 1 < LONG_ENTRANCE)
+					AddLink(cluster, grid.GetIndex(startX + (((runStart + runEnd) / 2) * stepX), startY + (((runStart + runEnd) / 2) * stepY)), direction);
+				else
+				{
+					AddLink(cluster, grid.GetIndex(startX + (runStart * stepX), startY + (runStart * stepY)), direction);
+					AddLink(cluster, grid.GetIndex(startX + (runEnd * stepX), startY + (runEnd * stepY)), direction);
+				}
+				runStart = -1;
+			}
+
+			// Track the start of each open stretch
+			if (isOpen && runStart == -1)
+			{
+				runStart = i;
+				runCost = crossCost;
+			}
+		}
+	}
+	// Adds the specified cell as an entrance of the cluster if it isn't already, and links it to its neighbour in the specified direction
+	void AddLink(Cluster& cluster, int node, int direction)
+	{
+		if (localIndex[node] == -1)
+		{
+			localIndex[node] = (int)cluster.nodes.size();
+			cluster.nodes.push_back(node);
+			cluster.links.push_back(std::vector<Link>());
+		}
+		cluster.links[localIndex[node]].push_back({ grid.GetNeighbour(node, direction), grid.GetCost(node, direction) });
+	}
+
+	/* ---- SEARCH FUNCTIONS ---- */
+	// Searches from the specified cell without leaving the specified cluster, returning true if the specified target was reached
+	// With no target (-1), every reachable cell in the cluster is closed with its cost. If reversed, costs are to the source rather than from it
+	bool SearchCluster(int source, int target, int clusterIndex, bool reverse, SearchContext& context) const
+	{
+		int x0, y0, x1, y1;
+		GetBounds(clusterIndex, x0, y0, x1, y1);
+
+		context.BeginSearch();
+		context.SetVisited(source);
+		context.scoreG[source] = 0;
+		context.prev[source] = -1;
+		context.listOpen.Push(source, 0);
+
+		while (context.listOpen.GetCount() > 0)
+		{
+			int current = context.listOpen.Pop();
+			context.SetClosed(current);
+			if (current == target)
+				return true;
+
+			for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+			{
+				// Skip blocked and closed cells, and cells outside the cluster
+				int neighbour = grid.GetNeighbour(current, n);
+				if (grid.IsBlocked(neighbour) || context.IsClosed(neighbour))
+					continue;
+				int x = grid.GetX(neighbour);
+				int y = grid.GetY(neighbour);
+				if (x < x0 || x > x1 || y < y0 || y > y1)
+					continue;
+
+				// When reversed, use the cost of the edge coming into the current cell
+				int cost = reverse ? grid.GetCost(neighbour, (n + 4) % NEIGHBOUR_COUNT) : grid.GetCost(current, n);
+				Relax(current, neighbour, context.scoreG[current] + cost, target, context);
+			}
+		}
+
+		return target == -1;
+	}
+	// Adds the specified cell to the open list with the specified cost, or updates it if this is a cheaper path to it
+	void Relax(int current, int neighbour, int newG, int target, SearchContext& context) const
+	{
+		if (context.IsClosed(neighbour))
+			return;
+
+		int scoreH = (target == -1) ? 0 : pathfinder.GetHeuristic(neighbour, target);
+		if (!context.IsVisited(neighbour))
+		{
+			context.SetVisited(neighbour);
+			context.scoreG[neighbour] = newG;
+			context.prev[neighbour] = current;
+			context.listOpen.Push(neighbour, newG + scoreH);
+		}
+		else if (newG < context.scoreG[neighbour])
+		{
+			context.scoreG[neighbour] = newG;
+			context.prev[neighbour] = current;
+			context.listOpen.DecreaseScore(neighbour, newG + scoreH);
+		}
+	}
+	// Gets the inclusive grid bounds of the specified cluster
+	void GetBounds(int clusterIndex, int& x0, int& y0, int& x1, int& y1) const
+	{
+		x0 = (clusterIndex % clustersX) * clusterSize;
+		y0 = (clusterIndex / clustersX) * clusterSize;
+		x1 = std::min(x0 + clusterSize, grid.GetWidth()) - 1;
+		y1 = std::min(y0 + clusterSize, grid.GetHeight()) - 1;
+	}
+
+	/* ---- VARIABLES ---- */
+	Pathfinder& pathfinder;					// The Pathfinder whose grid is abstracted
+	const PathGrid& grid;					// The Pathfinder's grid
+	int clusterSize;						// The width and height of each cluster, in cells
+	int clustersX;							// The number of clusters across the grid
+	int clustersY;							// The number of clusters up the grid
+	std::vector<Cluster> clusters;			// The entrances and costs of each cluster
+	std::vector<int> localIndex;			// The index of each cell in its cluster's entrances, or -1 if not an entrance
+	SearchContext buildContext;				// Search state used while rebuilding clusters
+	unsigned int version;					// The grid's version when the clusters were built, plus the changes reported since
+};
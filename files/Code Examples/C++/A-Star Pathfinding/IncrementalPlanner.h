@@ -0,0 +1,264 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <vector>
+#include "Pathfinder.h"
+
+/* ------------------------------
+INCREMENTALPLANNER CLASS
+
+The IncrementalPlanner keeps a path up to date for one agent as the map
+changes, using D* Lite.
+It searches backwards from the end cell, and keeps its search state
+between calls. When a cell is blocked, unblocked or has its costs
+changed, only the cells whose cost to the end is affected are searched
+again, rather than planning from scratch. The agent can move along the
+path without invalidating any of it.
+
+Each agent needs its own IncrementalPlanner, and must be told about every
+cell that changes after it starts planning (see OnNodeChanged).
+The heuristic used is the grid's lowest edge cost times the number of
+moves. This is weaker than the one AStarPath uses, but D* Lite relies on
+it never overestimating, even along the cheap train lines.
+-------------------------------*/
+
+class IncrementalPlanner
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the IncrementalPlanner to plan over the specified Pathfinder's grid
+	IncrementalPlanner(const Pathfinder& pathfinder) :
+		pathfinder(pathfinder),
+		grid(pathfinder.GetGrid()),
+		listOpen(pathfinder.GetGrid().GetCellCount())
+	{
+		nodeStart = -1;
+		nodeEnd = -1;
+		nodeLast = -1;
+		keyModifier = 0;
+		minCost = 0;
+	}
+
+	/* ---- PLANNING FUNCTIONS ---- */
+	// Plans a new path between the specified cells, returning true if a path was found, otherwise false
+	bool Plan(int start, int end)
+	{
+		// Reset all search state
+		nodeStart = start;
+		nodeEnd = end;
+		nodeLast = start;
+		keyModifier = 0;
+		minCost = grid.GetMinCost();
+		scoreG.assign(grid.GetCellCount(), (int)INFINITE);
+		scoreRhs.assign(grid.GetCellCount(), (int)INFINITE);
+		listOpen.Clear();
+		if (start == -1 || end == -1)
+			return false;
+
+		// Search backwards from the end cell
+		scoreRhs[nodeEnd] = 0;
+		listOpen.Push(nodeEnd, CalculateKey(nodeEnd));
+		ComputeShortestPath();
+		return HasPath();
+	}
+	// Moves the start of the path to the specified cell (normally the next cell along it), returning true if a path remains
+	bool MoveTo(int node)
+	{
+		nodeStart = node;
+		return HasPath();
+	}
+	// Repairs the path after the blocked flag or costs of the specified cell have changed, returning true if a path remains
+	// Call this for every changed cell, with the Pathfinder's grid already updated
+	bool OnNodeChanged(int node)
+	{
+		if (nodeEnd == -1)
+			return false;
+
+		// A cheaper edge than any before would make existing keys overestimate, so plan again from scratch
+		if (grid.GetMinCost() < minCost)
+			return Plan(nodeStart, nodeEnd);
+
+		// Existing keys are now lower bounds from the old start, so raise all new keys by how far the start has moved since
+		keyModifier += GetHeuristic(nodeLast, nodeStart);
+		nodeLast = nodeStart;
+
+		// Only the changed cell and its neighbours have edges that touch it, so only their costs to the end can change
+		UpdateRhs(node);
+		for (int n = 0; n < PathGrid::NEIGHBOURS; n++)
+		{
+			int neighbour = grid.GetNeighbour(node, n);
+			if (grid.IsInside(neighbour))
+				UpdateRhs(neighbour);
+		}
+
+		ComputeShortestPath();
+		return HasPath();
+	}
+
+	/* ---- PATH FUNCTIONS ---- */
+	// Returns true if the end can currently be reached from the start
+	bool HasPath() const
+	{
+		return nodeStart != -1 && nodeEnd != -1 && scoreG[nodeStart] < INFINITE && !grid.IsBlocked(nodeEnd);
+	}
+	// Returns the next cell to move to from the start of the path, or -1 if there is no path
+	int GetNextNode() const
+	{
+		if (!HasPath() || nodeStart == nodeEnd)
+			return -1;
+		return GetBestSuccessor(nodeStart);
+	}
+	// Stores the current path's cells, ordered from the end back to the start (matching SearchContext::path), returning false if there is no path
+	bool GetPath(std::vector<int>& path) const
+	{
+		path.clear();
+		if (!HasPath())
+			return false;
+
+		// Follow the cheapest successor from the start, then reverse
+		for (int current = nodeStart; current != nodeEnd; current = GetBestSuccessor(current))
+			path.push_back(current);
+		path.push_back(nodeEnd);
+		std::reverse(path.begin(), path.end());
+		return true;
+	}
+	// As above, but stores the path as world positions
+	bool GetPath(List<Vector2>& finalPath) const
+	{
+		std::vector<int> path;
+		finalPath.Clear();
+		if (!GetPath(path))
+			return false;
+
+		for (int node : path)
+			finalPath.Add(pathfinder.GetPosByNode(node));
+		return true;
+	}
+
+	/* ---- CONSTANTS ---- */
+	static const int INFINITE = INT_MAX / 2;		// The cost of an unreachable cell, low enough that adding a cost can't overflow
+
+private:
+	/* ---- SEARCH FUNCTIONS ---- */
+	// Processes cells until the start's cost to the end is correct
+	void ComputeShortestPath()
+	{
+		while (listOpen.GetCount() > 0 && (listOpen.GetTopScore() < CalculateKey(nodeStart) || scoreRhs[nodeStart] != scoreG[nodeStart]))
+		{
+			int current = listOpen.GetTop();
+			long long keyOld = listOpen.GetTopScore();
+			long long keyNew = CalculateKey(current);
+
+			// The key was calculated before the start moved, so re-queue it with the correct key
+			if (keyOld < keyNew)
+				listOpen.UpdateScore(current, keyNew);
+
+			// The cell's cost has dropped, so lock it in and pass it on to its predecessors
+			else if (scoreG[current] > scoreRhs[current])
+			{
+				scoreG[current] = scoreRhs[current];
+				listOpen.Remove(current);
+				for (int n = 0; n < PathGrid::NEIGHBOURS; n++)
+				{
+					int neighbour = grid.GetNeighbour(current, n);
+					if (grid.IsInside(neighbour) && neighbour != nodeEnd)
+					{
+						scoreRhs[neighbour] = std::min(scoreRhs[neighbour], GetCost(neighbour, (n + 4) % PathGrid::NEIGHBOURS) + scoreG[current]);
+						UpdateVertex(neighbour);
+					}
+				}
+			}
+
+			// The cell's cost has risen, so reset it and recalculate it and its predecessors
+			else
+			{
+				scoreG[current] = INFINITE;
+				UpdateRhs(current);
+				for (int n = 0; n < PathGrid::NEIGHBOURS; n++)
+				{
+					int neighbour = grid.GetNeighbour(current, n);
+					if (grid.IsInside(neighbour))
+						UpdateRhs(neighbour);
+				}
+			}
+		}
+	}
+	// Recalculates the specified cell's one-step lookahead cost from its successors, then updates its place in the open list
+	void UpdateRhs(int node)
+	{
+		if (node != nodeEnd)
+		{
+			int best = INFINITE;
+			for (int n = 0; n < PathGrid::NEIGHBOURS; n++)
+			{
+				int neighbour = grid.GetNeighbour(node, n);
+				best = std::min(best, GetCost(node, n) + scoreG[neighbour]);
+			}
+			scoreRhs[node] = std::min(best, (int)INFINITE);
+		}
+		UpdateVertex(node);
+	}
+	// Adds, re-orders or removes the specified cell in the open list depending on whether its cost is consistent
+	void UpdateVertex(int node)
+	{
+		bool isConsistent = scoreG[node] == scoreRhs[node];
+		bool isOpen = listOpen.Contains(node);
+		if (!isConsistent && isOpen)
+			listOpen.UpdateScore(node, CalculateKey(node));
+		else if (!isConsistent)
+			listOpen.Push(node, CalculateKey(node));
+		else if (isOpen)
+			listOpen.Remove(node);
+	}
+	// Returns the priority of the specified cell, packing the two parts of the D* Lite key so they compare in order
+	long long CalculateKey(int node) const
+	{
+		long long scoreMin = std::min(scoreG[node], scoreRhs[node]);
+		long long primary = scoreMin + GetHeuristic(nodeStart, node) + keyModifier;
+		return (primary << 32) + scoreMin;
+	}
+
+	/* ---- MISC. FUNCTIONS ---- */
+	// Returns the cost of moving from the specified cell to its specified neighbour, which is infinite if the neighbour is blocked
+	int GetCost(int node, int n) const
+	{
+		int neighbour = grid.GetNeighbour(node, n);
+		return grid.IsBlocked(neighbour) ? INFINITE : grid.GetCost(node, n);
+	}
+	// Returns the neighbour of the specified cell with the cheapest cost to the end
+	int GetBestSuccessor(int node) const
+	{
+		int best = -1;
+		int bestCost = INFINITE;
+		for (int n = 0; n < PathGrid::NEIGHBOURS; n++)
+		{
+			int neighbour = grid.GetNeighbour(node, n);
+			int cost = GetCost(node, n) + scoreG[neighbour];
+			if (cost < bestCost)
+			{
+				best = neighbour;
+				bestCost = cost;
+			}
+		}
+		return best;
+	}
+	// Returns a lower bound on the cost between the specified cells, from the number of moves and the lowest edge cost
+	int GetHeuristic(int fromNode, int toNode) const
+	{
+		int dX = abs(grid.GetX(fromNode) - grid.GetX(toNode));
+		int dY = abs(grid.GetY(fromNode) - grid.GetY(toNode));
+		return minCost * std::max(dX, dY);
+	}
+
+	/* ---- VARIABLES ---- */
+	const Pathfinder& pathfinder;				// The Pathfinder whose grid is planned over
+	const PathGrid& grid;						// The Pathfinder's grid
+	BasicNodeHeap<long long> listOpen;			// The cells whose cost is inconsistent, ordered by key
+	std::vector<int> scoreG;					// The cost from each cell to the end, as of its last expansion
+	std::vector<int> scoreRhs;					// The cost from each cell to the end, looking one step ahead
+	int nodeStart;								// The cell the agent is currently at
+	int nodeEnd;								// The cell the agent is heading to
+	int nodeLast;								// The start cell when the map last changed
+	int keyModifier;							// How far keys have been raised by the start moving (km in D* Lite)
+	int minCost;								// The lowest edge cost, used by the heuristic
+};
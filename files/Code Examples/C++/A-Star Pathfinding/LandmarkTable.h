@@ -0,0 +1,196 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <vector>
+#include "NodeHeap.h"
+#include "PathGrid.h"
+
+/* ------------------------------
+LANDMARKTABLE CLASS
+
+The LandmarkTable provides the heuristic for SearchMode::Landmark, using
+ALT (A*, Landmarks and the Triangle inequality).
+A few landmark cells are chosen spread out across the map, and the exact
+cost to and from every cell to each landmark is found ahead of time.
+For any landmark L, the cost from v to t can't be less than
+cost(v, L) - cost(t, L), or cost(L, t) - cost(L, v), so the best of these
+bounds over all landmarks is used as the estimate.
+
+Unlike the octile heuristic, these bounds account for the cheap train
+lines, so the estimate never overestimates and stays tight along them.
+Paths found are optimal, and searches that ride the trains expand far
+fewer cells.
+
+The table stays valid while cells are only blocked (costs only rise),
+but must be rebuilt after a cell is unblocked or a cost is lowered.
+-------------------------------*/
+
+class LandmarkTable
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes an empty LandmarkTable, which must be built before use
+	LandmarkTable()
+	{
+		grid = nullptr;
+		landmarkCount = 0;
+		minCost = 0;
+	}
+
+	/* ---- BUILD FUNCTIONS ---- */
+	// Chooses the specified number of landmarks on the specified grid and finds the cost to and from each of them
+	void Build(const PathGrid& grid, int count)
+	{
+		Clear();
+		this->grid = &grid;
+		minCost = grid.GetMinCost();
+		int cellCount = grid.GetCellCount();
+
+		// Find any open cell to start from, giving up if there are none
+		int seed = -1;
+		for (int cell = 0; cell < cellCount && seed == -1; cell++)
+		{
+			if (!grid.IsBlocked(cell))
+				seed = cell;
+		}
+		if (seed == -1 || count <= 0)
+		{
+			Clear();
+			return;
+		}
+
+		// The first landmark is the cell furthest from the seed, and each after that is the cell furthest from all landmarks so far
+		std::vector<int> from(cellCount);
+		std::vector<int> to(cellCount);
+		std::vector<int> nearest(cellCount, (int)INFINITE);
+		FindCosts(seed, false, from);
+		int next = GetFurthest(from);
+		while ((int)landmarks.size() < count && next != -1)
+		{
+			landmarks.push_back(next);
+			FindCosts(next, false, from);
+			FindCosts(next, true, to);
+			fromLandmark.insert(fromLandmark.end(), from.begin(), from.end());
+			toLandmark.insert(toLandmark.end(), to.begin(), to.end());
+
+			for (int cell = 0; cell < cellCount; cell++)
+				nearest[cell] = std::min(nearest[cell], from[cell]);
+			next = GetFurthest(nearest);
+		}
+		landmarkCount = (int)landmarks.size();
+
+		// Interleave the tables so each cell's costs to all landmarks are read together
+		Interleave(fromLandmark, cellCount);
+		Interleave(toLandmark, cellCount);
+	}
+	// Empties the LandmarkTable, so it has to be built again before use
+	void Clear()
+	{
+		landmarkCount = 0;
+		landmarks.clear();
+		fromLandmark.clear();
+		toLandmark.clear();
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	// Returns a lower bound on the cost of moving from the first specified cell to the second
+	int GetHeuristic(int fromNode, int toNode) const
+	{
+		// Fall back on the number of moves times the cheapest edge
+		int dX = abs(grid->GetX(fromNode) - grid->GetX(toNode));
+		int dY = abs(grid->GetY(fromNode) - grid->GetY(toNode));
+		int best = minCost * std::max(dX, dY);
+
+		// Use the tightest bound from the landmarks, skipping any that either cell can't reach or be reached from
+		const int* fromA = &fromLandmark[fromNode * landmarkCount];
+		const int* fromB = &fromLandmark[toNode * landmarkCount];
+		const int* toA = &toLandmark[fromNode * landmarkCount];
+		const int* toB = &toLandmark[toNode * landmarkCount];
+		for (int i = 0; i < landmarkCount; i++)
+		{
+			if (toA[i] != INFINITE && toB[i] != INFINITE)
+				best = std::max(best, toA[i] - toB[i]);
+			if (fromA[i] != INFINITE && fromB[i] != INFINITE)
+				best = std::max(best, fromB[i] - fromA[i]);
+		}
+		return best;
+	}
+	bool IsBuilt() const // Returns true if the LandmarkTable has been built and not cleared since
+	{
+		return landmarkCount > 0;
+	}
+	const std::vector<int>& GetLandmarks() const // Returns the landmark cells
+	{
+		return landmarks;
+	}
+
+	/* ---- CONSTANTS ---- */
+	static const int INFINITE = INT_MAX;		// The cost stored for cells that can't reach or be reached from a landmark
+
+private:
+	// Finds the cost from the specified cell to every other (or from every other to it if reversed) using Dijkstra's algorithm
+	void FindCosts(int source, bool reverse, std::vector<int>& costs) const
+	{
+		NodeHeap listOpen(grid->GetCellCount());
+		std::fill(costs.begin(), costs.end(), (int)INFINITE);
+		costs[source] = 0;
+		listOpen.Push(source, 0);
+
+		while (listOpen.GetCount() > 0)
+		{
+			int current = listOpen.Pop();
+			for (int n = 0; n < PathGrid::NEIGHBOURS; n++)
+			{
+				int neighbour = grid->GetNeighbour(current, n);
+				if (grid->IsBlocked(neighbour))
+					continue;
+
+				// Reversed, the edge runs from the neighbour back to the current cell
+				int cost = costs[current] + (reverse ? grid->GetCost(neighbour, (n + 4) % PathGrid::NEIGHBOURS) : grid->GetCost(current, n));
+				if (cost >= costs[neighbour])
+					continue;
+
+				bool isOpen = costs[neighbour] != INFINITE;
+				costs[neighbour] = cost;
+				if (isOpen)
+					listOpen.DecreaseScore(neighbour, cost);
+				else
+					listOpen.Push(neighbour, cost);
+			}
+		}
+	}
+	// Returns the reachable cell with the highest of the specified costs, or -1 if every cell has a cost of 0
+	int GetFurthest(const std::vector<int>& costs) const
+	{
+		int furthest = -1;
+		int furthestCost = 0;
+		for (int cell = 0; cell < (int)costs.size(); cell++)
+		{
+			if (costs[cell] != INFINITE && costs[cell] > furthestCost)
+			{
+				furthest = cell;
+				furthestCost = costs[cell];
+			}
+		}
+		return furthest;
+	}
+	// Reorders the specified table from one block of cells per landmark into one block of landmarks per cell
+	void Interleave(std::vector<int>& table, int cellCount) const
+	{
+		std::vector<int> interleaved(table.size());
+		for (int i = 0; i < landmarkCount; i++)
+		{
+			for (int cell = 0; cell < cellCount; cell++)
+				interleaved[(cell * landmarkCount) + i] = table[(i * cellCount) + cell];
+		}
+		table.swap(interleaved);
+	}
+
+	/* ---- VARIABLES ---- */
+	const PathGrid* grid;				// The grid the LandmarkTable was built for
+	std::vector<int> landmarks;			// The landmark cells
+	std::vector<int> fromLandmark;		// The cost from each landmark to each cell, landmarkCount per cell
+	std::vector<int> toLandmark;		// The cost from each cell to each landmark, landmarkCount per cell
+	int landmarkCount;					// The number of landmarks
+	int minCost;						// The lowest edge cost, used when no landmark gives a better bound
+};
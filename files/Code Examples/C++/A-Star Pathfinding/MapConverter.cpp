@@ -0,0 +1,34 @@
+#include <cstdio>
+#include "Pathfinder.h"
+
+/* ------------------------------
+MAPCONVERTER
+
+A small command-line tool that writes the built-in PTV train network out
+as a binary map, for the Pathfinder to load instead of building it.
+Build it alongside Pathfinder.cpp and MappedFile.cpp, then run:
+	MapConverter <output path>
+The map is written in the machine's byte order, so it should be created
+on the same kind of machine that loads it.
+-------------------------------*/
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2)
+	{
+		printf("Usage: %s <output path>\n", argv[0]);
+		return 1;
+	}
+
+	// Build the train network and save it
+	Pathfinder pathfinder;
+	if (!pathfinder.SaveMap(argv[1]))
+	{
+		printf("Could not write map to '%s'\n", argv[1]);
+		return 1;
+	}
+
+	const PathGrid& grid = pathfinder.GetGrid();
+	printf("Wrote %dx%d map to '%s'\n", grid.GetWidth(), grid.GetHeight(), argv[1]);
+	return 0;
+}
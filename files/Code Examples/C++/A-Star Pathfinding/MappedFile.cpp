@@ -0,0 +1,105 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+MappedFile::MappedFile()
+{
+	data = nullptr;
+	size = 0;
+	mapping = nullptr;
+}
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+/* ---- FILE FUNCTIONS ---- */
+#ifdef _WIN32
+bool MappedFile::Open(const char* path)
+{
+	Close();
+
+	// Open the file and find its size (empty files can't be mapped)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	// Map the whole file, then close the file handle as the mapping keeps it open
+	HANDLE handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (handle == nullptr)
+		return false;
+	void* view = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(handle);
+		return false;
+	}
+
+	data = (const unsigned char*)view;
+	size = (size_t)fileSize.QuadPart;
+	mapping = handle;
+	return true;
+}
+void MappedFile::Close()
+{
+	if (data != nullptr)
+	{
+		UnmapViewOfFile(data);
+		CloseHandle((HANDLE)mapping);
+	}
+	data = nullptr;
+	size = 0;
+	mapping = nullptr;
+}
+#else
+bool MappedFile::Open(const char* path)
+{
+	Close();
+
+	// Open the file and find its size (empty files can't be mapped)
+	int file = open(path, O_RDONLY);
+	if (file == -1)
+		return false;
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	// Map the whole file, then close the file as the mapping keeps it open
+	void* view = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (view == MAP_FAILED)
+		return false;
+
+	data = (const unsigned char*)view;
+	size = (size_t)status.st_size;
+	return true;
+}
+void MappedFile::Close()
+{
+	if (data != nullptr)
+		munmap((void*)data, size);
+	data = nullptr;
+	size = 0;
+	mapping = nullptr;
+}
+#endif
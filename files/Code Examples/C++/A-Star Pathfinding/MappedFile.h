@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+
+/* ------------------------------
+MAPPEDFILE CLASS
+
+The MappedFile maps a whole file into memory, read-only, so it can be
+read in place without copying it through a buffer first.
+Pages are only read from disk as they are touched, and are shared with
+any other process mapping the same file.
+Uses mmap on POSIX systems and file mappings on Windows; the platform
+code is kept in MappedFile.cpp so neither set of system headers leaks
+into the rest of the project.
+-------------------------------*/
+
+class MappedFile
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the MappedFile with no file mapped
+	MappedFile();
+	// Unmaps the file, if one is mapped
+	~MappedFile();
+
+	/* ---- FILE FUNCTIONS ---- */
+	// Maps the file at the specified path, returning true if successful, otherwise false
+	bool Open(const char* path);
+	// Unmaps the current file, if one is mapped
+	void Close();
+
+	/* ---- GETTER FUNCTIONS ---- */
+	const unsigned char* GetData() const // Returns the start of the mapped file, or nullptr if none is mapped
+	{
+		return data;
+	}
+	size_t GetSize() const // Returns the size of the mapped file in bytes
+	{
+		return size;
+	}
+
+private:
+	// A mapping can't be shared, so MappedFiles can't be copied
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/* ---- VARIABLES ---- */
+	const unsigned char* data;		// The start of the mapped file
+	size_t size;					// The size of the mapped file in bytes
+	void* mapping;					// The file mapping handle (Windows only, as POSIX mappings outlive their file)
+};
@@ -0,0 +1,171 @@
+#pragma once
+#include <vector>
+
+/* ------------------------------
+NODEHEAP CLASS
+
+The NodeHeap is a binary min-heap of cells ordered by score, used as the
+open list for A*. BasicNodeHeap allows other score types, such as the
+two-part keys of D* Lite packed into a long long.
+Each cell's slot in the heap is stored in a per-cell array, so checking
+whether a cell is open and re-ordering it after a cheaper path is found
+don't need to search the heap. Scores are stored alongside the cells so
+sifting never has to look them up elsewhere.
+-------------------------------*/
+
+template<typename Score>
+class BasicNodeHeap
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the NodeHeap to hold cells with an index below the specified count
+	BasicNodeHeap(int cellCount = 0)
+	{
+		slots.assign(cellCount, -1);
+	}
+
+	/* ---- PUSH & POP FUNCTIONS ---- */
+	// Adds the specified cell to the NodeHeap with the specified score and sifts it into position
+	void Push(int cell, Score score)
+	{
+		data.push_back({ cell, score });
+		SiftUp((int)data.size() - 1);
+	}
+	// Removes and returns the cell with the lowest score
+	int Pop()
+	{
+		// Take the top cell and mark it as no longer in the NodeHeap
+		int top = data[0].cell;
+		slots[top] = -1;
+
+		// Move the last cell to the top and sift it back down into position
+		Entry last = data.back();
+		data.pop_back();
+		if (!data.empty())
+		{
+			data[0] = last;
+			SiftDown(0);
+		}
+
+		return top;
+	}
+
+	/* ---- ORDERING FUNCTIONS ---- */
+	// Lowers the score of the specified cell, which must already be in the NodeHeap, and re-orders it
+	void DecreaseScore(int cell, Score score)
+	{
+		int index = slots[cell];
+		data[index].score = score;
+		SiftUp(index);
+	}
+	// Changes the score of the specified cell, which must already be in the NodeHeap, and re-orders it
+	void UpdateScore(int cell, Score score)
+	{
+		int index = slots[cell];
+		data[index].score = score;
+		SiftUp(index);
+		SiftDown(slots[cell]);
+	}
+	// Removes the specified cell, which must already be in the NodeHeap
+	void Remove(int cell)
+	{
+		// Move the last entry into the removed slot and re-order it
+		int index = slots[cell];
+		slots[cell] = -1;
+		Entry last = data.back();
+		data.pop_back();
+		if (index < (int)data.size())
+		{
+			Place(last, index);
+			SiftUp(index);
+			SiftDown(slots[last.cell]);
+		}
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	// Returns true if the specified cell is currently in the NodeHeap
+	bool Contains(int cell) const
+	{
+		return slots[cell] != -1;
+	}
+	int GetTop() const // Returns the cell with the lowest score, without removing it
+	{
+		return data[0].cell;
+	}
+	Score GetTopScore() const // Returns the lowest score in the NodeHeap
+	{
+		return data[0].score;
+	}
+	int GetCount() const // Returns the number of cells in the NodeHeap
+	{
+		return (int)data.size();
+	}
+
+	/* ---- MISC. FUNCTIONS ---- */
+	// Removes all cells from the NodeHeap, resetting their slots
+	void Clear()
+	{
+		for (const Entry& entry : data)
+			slots[entry.cell] = -1;
+		data.clear();
+	}
+
+private:
+	/* ---- NESTED CLASSES/STRUCTS ---- */
+	struct Entry
+	{
+		int cell;			// The cell index
+		Score score;		// The score the cell is ordered by
+	};
+
+	// Moves the entry at the specified slot up until its parent has a lower or equal score
+	void SiftUp(int index)
+	{
+		Entry entry = data[index];
+		while (index > 0)
+		{
+			int parent = (index - 1) / 2;
+			if (data[parent].score <= entry.score)
+				break;
+
+			Place(data[parent], index);
+			index = parent;
+		}
+		Place(entry, index);
+	}
+	// Moves the entry at the specified slot down until both children have a higher or equal score
+	void SiftDown(int index)
+	{
+		Entry entry = data[index];
+		int count = (int)data.size();
+		while (true)
+		{
+			// Find the cheaper child, stopping if there are none
+			int child = (index * 2) + 1;
+			if (child >= count)
+				break;
+			if (child + 1 < count && data[child + 1].score < data[child].score)
+				child++;
+
+			if (entry.score <= data[child].score)
+				break;
+
+			Place(data[child], index);
+			index = child;
+		}
+		Place(entry, index);
+	}
+	// Stores the specified entry in the specified slot and updates the cell's slot
+	void Place(const Entry& entry, int index)
+	{
+		data[index] = entry;
+		slots[entry.cell] = index;
+	}
+
+	/* ---- VARIABLES ---- */
+	std::vector<Entry> data;		// The entries in the NodeHeap, stored as an implicit binary tree
+	std::vector<int> slots;			// The slot of each cell in the NodeHeap, or -1 when not in the NodeHeap
+};
+
+// The NodeHeap used by A*, with integer scores
+typedef BasicNodeHeap<int> NodeHeap;
@@ -0,0 +1,85 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "Pathfinder.h"
+
+/* ------------------------------
+PATHARENA CLASS
+
+The PathArena stores many paths back to back in one block of cell
+indices, such as every path found by agents during a tick, rather than
+giving each path its own list.
+Paths are written straight out of a SearchContext in order from start to
+end (see Pathfinder::WritePath), and each is returned as a PathSpan
+marking where it sits in the block.
+
+Reset empties the arena without freeing the block, so once it has grown
+to fit a busy tick, later ticks write paths without allocating at all.
+Writing a path can grow the block, which moves every path in it, so
+paths are read back through their PathSpan rather than kept as pointers.
+-------------------------------*/
+
+// Where a single path sits in a PathArena
+struct PathSpan
+{
+	int first = 0;		// The index of the path's first cell in the arena
+	int count = 0;		// The number of cells in the path (0 if no path was found)
+};
+
+class PathArena
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes an empty PathArena with room for the specified number of cells before it needs to grow
+	PathArena(int capacity = DEFAULT_CAPACITY)
+	{
+		cells.resize(std::max(1, capacity));
+		used = 0;
+	}
+
+	/* ---- WRITE FUNCTIONS ---- */
+	// Writes the path stored in the specified SearchContext to the end of the arena in the specified PathFormat, returning where it was written
+	PathSpan Write(const Pathfinder& pathfinder, const SearchContext& context, PathFormat format = PathFormat::Cells)
+	{
+		PathSpan span;
+		span.first = used;
+		span.count = pathfinder.WritePath(context, cells.data() + used, (int)cells.size() - used, format);
+
+		// If the path didn't fit, grow the block (at least doubling, so growing stays rare) and write it again
+		if (used + span.count > (int)cells.size())
+		{
+			cells.resize(std::max(cells.size() * 2, (size_t)(used + span.count)));
+			pathfinder.WritePath(context, cells.data() + used, span.count, format);
+		}
+		used += span.count;
+		return span;
+	}
+	// Empties the arena, keeping its block to write the next paths into
+	void Reset()
+	{
+		used = 0;
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	// Returns the first cell of the path at the specified PathSpan, with the rest following in order to its end
+	const int* GetCells(PathSpan span) const
+	{
+		return cells.data() + span.first;
+	}
+	int GetUsed() const // Returns the number of cells written since the arena was last reset
+	{
+		return used;
+	}
+	int GetCapacity() const // Returns the number of cells the arena can hold before it needs to grow
+	{
+		return (int)cells.size();
+	}
+
+	/* ---- CONSTANTS ---- */
+	static const int DEFAULT_CAPACITY = 4096;		// The default number of cells the arena starts with room for (16 KB)
+
+private:
+	/* ---- VARIABLES ---- */
+	std::vector<int> cells;		// The block the paths are written into, back to back
+	int used;					// The number of cells written since the arena was last reset
+};
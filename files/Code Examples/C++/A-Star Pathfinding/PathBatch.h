@@ -0,0 +1,172 @@
+#pragma once
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include "Pathfinder.h"
+#include "ThreadPool.h"
+
+/* ------------------------------
+PATHBATCH CLASS
+
+The PathBatch runs many path requests against one Pathfinder at once,
+spread across a ThreadPool with a SearchContext per worker.
+
+Work is shared between requests where possible:
+- Identical requests (same start and end cell) are only searched once.
+- Requests with the same end cell are grouped together, longest first.
+  If a later request starts on a cell along an already-found path to
+  the same end, it reuses the rest of that path instead of searching.
+
+The Pathfinder's map must not be changed while a batch is running.
+-------------------------------*/
+
+// The outcome of a single request in a batch
+enum class PathStatus
+{
+	Found,			// A path was found
+	NoPath,			// The start and end are inside the grid, but no path connects them
+	OutOfBounds		// The start or end is outside the grid
+};
+
+// A single path request, between two world positions
+struct PathRequest
+{
+	Vector2 start;
+	Vector2 end;
+};
+
+// The result of a single path request
+struct PathResult
+{
+	PathStatus status = PathStatus::NoPath;		// Whether a path was found
+	std::vector<Vector2> path;					// The path found, ordered from the end back to the start (matching AStarPath)
+};
+
+class PathBatch
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the PathBatch to query the specified Pathfinder with the specified number of workers (or one per core if 0)
+	PathBatch(const Pathfinder& pathfinder, int workerCount = 0) : pathfinder(pathfinder), pool(workerCount)
+	{
+		// Create a SearchContext for each worker
+		int cellCount = pathfinder.GetGrid().GetCellCount();
+		for (int i = 0; i < pool.GetWorkerCount(); i++)
+			contexts.push_back(SearchContext(cellCount));
+	}
+
+	/* ---- RUN FUNCTIONS ---- */
+	// Finds paths for all of the specified requests using the specified SearchMode, storing a result for each in the same order
+	void Run(const std::vector<PathRequest>& requests, std::vector<PathResult>& results, SearchMode mode = SearchMode::AStar)
+	{
+		int count = (int)requests.size();
+		results.assign(count, PathResult());
+
+		/* --- DEDUPLICATION --- */
+
+		// Find the cells of each request, and mark repeats of an earlier request as duplicates
+		std::vector<int> startCells(count);
+		std::vector<int> endCells(count);
+		std::vector<int> original(count, -1);
+		std::unordered_map<long long, int> firstRequest;
+		std::unordered_map<int, std::vector<int>> requestsByEnd;
+		for (int i = 0; i < count; i++)
+		{
+			startCells[i] = pathfinder.GetNodeByPos(requests[i].start);
+			endCells[i] = pathfinder.GetNodeByPos(requests[i].end);
+			if (startCells[i] == -1 || endCells[i] == -1)
+			{
+				results[i].status = PathStatus::OutOfBounds;
+				continue;
+			}
+
+			// Only the first of any identical requests is searched
+			long long key = ((long long)startCells[i] << 32) | (unsigned int)endCells[i];
+			auto found = firstRequest.find(key);
+			if (found != firstRequest.end())
+			{
+				original[i] = found->second;
+				continue;
+			}
+			firstRequest[key] = i;
+			requestsByEnd[endCells[i]].push_back(i);
+		}
+
+		// Split the requests sharing each end cell into tasks, longest requests first so later ones can reuse their paths
+		std::vector<std::vector<int>> tasks;
+		for (auto& group : requestsByEnd)
+		{
+			std::vector<int>& members = group.second;
+			std::sort(members.begin(), members.end(), [&](int a, int b)
+			{
+				return pathfinder.GetHeuristic(startCells[a], endCells[a]) > pathfinder.GetHeuristic(startCells[b], endCells[b]);
+			});
+
+			for (int first = 0; first < (int)members.size(); first += REQUESTS_PER_TASK)
+			{
+				int last = std::min(first + REQUESTS_PER_TASK, (int)members.size());
+				tasks.push_back(std::vector<int>(members.begin() + first, members.begin() + last));
+			}
+		}
+
+		/* --- PATHFINDING --- */
+
+		pool.Run((int)tasks.size(), [&](int task, int worker)
+		{
+			RunTask(tasks[task], startCells, endCells, mode, contexts[worker], results);
+		});
+
+		// Copy results to the duplicate requests
+		for (int i = 0; i < count; i++)
+		{
+			if (original[i] != -1)
+				results[i] = results[original[i]];
+		}
+	}
+
+	/* ---- CONSTANTS ---- */
+	static const int REQUESTS_PER_TASK = 16;		// The most requests sharing an end cell that are run as one task
+
+private:
+	// Finds paths for the specified requests, which all share an end cell, reusing earlier paths where possible
+	void RunTask(const std::vector<int>& requestIds, const std::vector<int>& startCells, const std::vector<int>& endCells, SearchMode mode, SearchContext& context, std::vector<PathResult>& results)
+	{
+		// The request and path position of each cell along the paths found so far
+		std::unordered_map<int, std::pair<int, int>> pathCells;
+
+		for (int id : requestIds)
+		{
+			PathResult& result = results[id];
+
+			// If the start cell is on an earlier path, the rest of that path also leads to the end
+			auto found = pathCells.find(startCells[id]);
+			if (found != pathCells.end())
+			{
+				const std::vector<Vector2>& earlier = results[found->second.first].path;
+				result.status = PathStatus::Found;
+				result.path.assign(earlier.begin(), earlier.begin() + found->second.second + 1);
+				continue;
+			}
+
+			// Otherwise search for a new path
+			if (!pathfinder.FindPath(startCells[id], endCells[id], context, mode))
+			{
+				result.status = PathStatus::NoPath;
+				continue;
+			}
+
+			// Store the path found, and remember its cells for later requests
+			result.status = PathStatus::Found;
+			for (int current : context.path)
+			{
+				pathCells.emplace(current, std::make_pair(id, (int)result.path.size()));
+				result.path.push_back(pathfinder.GetPosByNode(current));
+			}
+		}
+	}
+
+	/* ---- VARIABLES ---- */
+	const Pathfinder& pathfinder;				// The Pathfinder being queried
+	ThreadPool pool;							// The workers the requests are spread across
+	std::vector<SearchContext> contexts;		// The search state of each worker
+};
@@ -0,0 +1,223 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "Pathfinder.h"
+
+/* ------------------------------
+PATHCACHE CLASS
+
+The PathCache sits in front of a Pathfinder and remembers recent
+results, so agents asking for the same start and end cells (often many
+times in one tick) only cause one search.
+
+Results are kept in least-recently-used order, and the oldest are
+dropped once the cells stored across all paths reach a fixed limit.
+Failed searches are cached too, as they are usually the most expensive.
+
+Each result also remembers the band of rows its search scored cells in.
+A search can only be affected by cells it scored or that neighbour them,
+so when a cell is blocked, unblocked or has its costs changed, only the
+results whose band (plus one row either side) contains it are dropped.
+Jump Point Search looks along whole rows and columns without scoring
+them, so its results are dropped by any change.
+
+Any number of threads can use the PathCache at once, each with its own
+SearchContext. The map must not be changed while searches are running.
+-------------------------------*/
+
+class PathCache
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the PathCache in front of the specified Pathfinder, storing paths of up to the specified number of cells in total
+	PathCache(Pathfinder& pathfinder, int maxCells = DEFAULT_MAX_CELLS) : pathfinder(pathfinder), grid(pathfinder.GetGrid())
+	{
+		this->maxCells = maxCells;
+		cellsStored = 0;
+		hits = 0;
+		misses = 0;
+	}
+
+	/* ---- PATHFINDING FUNCTIONS ---- */
+	// Finds a path between the two specified world positions, returning true if a path was found, otherwise false
+	bool FindPath(Vector2 start, Vector2 end, List<Vector2>& finalPath, SearchContext& context, SearchMode mode = SearchMode::AStar)
+	{
+		// Clear the path, and search between the start and end cells
+		finalPath.Clear();
+		if (!FindPath(pathfinder.GetNodeByPos(start), pathfinder.GetNodeByPos(end), context, mode))
+			return false;
+
+		// Path has been found, so add it
+		for (int current : context.path)
+			finalPath.Add(pathfinder.GetPosByNode(current));
+		return true;
+	}
+	// Finds a path between the two specified cells, using a cached result if there is one, returning true if a path was found, otherwise false
+	// When found, the path's cells are stored in the SearchContext
+	bool FindPath(int nodeStart, int nodeEnd, SearchContext& context, SearchMode mode = SearchMode::AStar)
+	{
+		// Cells outside the grid are never searched, so don't need caching
+		if (nodeStart == -1 || nodeEnd == -1)
+			return pathfinder.FindPath(nodeStart, nodeEnd, context, mode);
+
+		// Use the cached result if there is one, marking it as the most recently used
+		long long key = GetKey(nodeStart, nodeEnd, mode);
+		{
+			std::lock_guard<std::mutex> lock(cacheLock);
+			auto found = entries.find(key);
+			if (found != entries.end())
+			{
+				hits++;
+				order.splice(order.begin(), order, found->second);
+				context.path = found->second->path;
+				return found->second->isFound;
+			}
+			misses++;
+		}
+
+		// Otherwise search without holding the lock, so other threads can use the cache meanwhile
+		bool isFound = pathfinder.FindPath(nodeStart, nodeEnd, context, mode);
+
+		// Store the result, along with the rows the search depended on (always including the start and end, for early exits)
+		Entry entry;
+		entry.key = key;
+		entry.isFound = isFound;
+		entry.path = context.path;
+		entry.firstRow = std::min(grid.GetY(nodeStart), grid.GetY(nodeEnd));
+		entry.lastRow = std::max(grid.GetY(nodeStart), grid.GetY(nodeEnd));
+		if (mode == SearchMode::JumpPoint)
+		{
+			entry.firstRow = 0;
+			entry.lastRow = grid.GetHeight() - 1;
+		}
+		else if (context.lastVisited != -1)
+		{
+			entry.firstRow = std::min(entry.firstRow, grid.GetY(context.firstVisited));
+			entry.lastRow = std::max(entry.lastRow, grid.GetY(context.lastVisited));
+		}
+		entry.firstRow--;
+		entry.lastRow++;
+
+		std::lock_guard<std::mutex> lock(cacheLock);
+		if (entries.find(key) == entries.end())
+			Insert(entry);
+		return isFound;
+	}
+
+	/* ---- INVALIDATION FUNCTIONS ---- */
+	// Sets whether the cell at the specified world position can be traversed, dropping any results it could affect
+	void SetBlocked(Vector2 pos, bool isBlocked)
+	{
+		pathfinder.SetBlocked(pos, isBlocked);
+
+		int node = pathfinder.GetNodeByPos(pos);
+		if (node != -1)
+			OnNodeChanged(node);
+	}
+	// Drops any results that could be affected by a change to the specified cell's blocked flag or costs
+	void OnNodeChanged(int node)
+	{
+		std::lock_guard<std::mutex> lock(cacheLock);
+		int row = grid.GetY(node);
+		for (auto it = order.begin(); it != order.end();)
+		{
+			if (row >= it->firstRow && row <= it->lastRow)
+				it = Erase(it);
+			else
+				++it;
+		}
+	}
+	// Drops every result, such as after loading a new map
+	void Clear()
+	{
+		std::lock_guard<std::mutex> lock(cacheLock);
+		order.clear();
+		entries.clear();
+		cellsStored = 0;
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	int GetHits() const // Returns the number of queries answered from the cache
+	{
+		std::lock_guard<std::mutex> lock(cacheLock);
+		return hits;
+	}
+	int GetMisses() const // Returns the number of queries that needed a search
+	{
+		std::lock_guard<std::mutex> lock(cacheLock);
+		return misses;
+	}
+	int GetEntryCount() const // Returns the number of results currently cached
+	{
+		std::lock_guard<std::mutex> lock(cacheLock);
+		return (int)entries.size();
+	}
+	int GetCellsStored() const // Returns the number of path cells currently stored across all results
+	{
+		std::lock_guard<std::mutex> lock(cacheLock);
+		return cellsStored;
+	}
+	void ResetCounters() // Sets the hit and miss counters back to 0
+	{
+		std::lock_guard<std::mutex> lock(cacheLock);
+		hits = 0;
+		misses = 0;
+	}
+
+	/* ---- CONSTANTS ---- */
+	static const int DEFAULT_MAX_CELLS = 65536;		// The default limit on path cells stored (256 KB of cell indices)
+
+private:
+	/* ---- NESTED CLASSES/STRUCTS ---- */
+	struct Entry
+	{
+		long long key;				// The start cell, end cell and mode of the query
+		bool isFound;				// Whether a path was found
+		std::vector<int> path;		// The path's cells, ordered from the end back to the start
+		int firstRow;				// The first row a change to which could affect this result
+		int lastRow;				// The last row a change to which could affect this result
+	};
+
+	// Adds the specified entry as the most recently used, dropping the least recently used until it fits
+	void Insert(Entry& entry)
+	{
+		// Every entry counts as at least one cell, so failed searches are bounded too
+		int cells = std::max(1, (int)entry.path.size());
+		if (cells > maxCells)
+			return;
+		while (cellsStored + cells > maxCells)
+			Erase(std::prev(order.end()));
+
+		order.push_front(std::move(entry));
+		entries[order.front().key] = order.begin();
+		cellsStored += cells;
+	}
+	// Removes the specified entry, returning the one after it
+	std::list<Entry>::iterator Erase(std::list<Entry>::iterator it)
+	{
+		cellsStored -= std::max(1, (int)it->path.size());
+		entries.erase(it->key);
+		return order.erase(it);
+	}
+	// Returns the key of the query between the specified cells with the specified mode
+	long long GetKey(int nodeStart, int nodeEnd, SearchMode mode) const
+	{
+		long long cellCount = grid.GetCellCount();
+		return ((((long long)mode * cellCount) + nodeStart) * cellCount) + nodeEnd;
+	}
+
+	/* ---- VARIABLES ---- */
+	Pathfinder& pathfinder;											// The Pathfinder being queried
+	const PathGrid& grid;											// The Pathfinder's grid
+	std::list<Entry> order;											// The cached results, most recently used first
+	std::unordered_map<long long, std::list<Entry>::iterator> entries;	// The cached result of each query
+	mutable std::mutex cacheLock;									// Guards the cached results and counters
+	int maxCells;													// The most path cells stored across all results
+	int cellsStored;												// The path cells currently stored across all results
+	int hits;														// The number of queries answered from the cache
+	int misses;														// The number of queries that needed a search
+};
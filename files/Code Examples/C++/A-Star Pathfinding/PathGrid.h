@@ -0,0 +1,596 @@
+#pragma once
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <assert.h>
+
+/* ------------------------------
+PATHGRID CLASS
+
+The PathGrid stores the map used for pathfinding as flat arrays, one
+entry per cell, rather than as a grid of individually allocated nodes.
+Each cell has a colour, eight edge costs and a blocked flag, each kept
+in its own contiguous array.
+
+The grid is padded with a one-cell border of permanently blocked cells,
+so a neighbour is always found with a fixed index offset and never needs
+a bounds check.
+Edge costs are stored as one byte per edge, indexing a small table of
+the distinct cost values used by the map.
+
+A cell is 'uniform' when it and all of its neighbours are unblocked and
+only use the standard straight and diagonal costs the grid was created
+with. Uniform cells are kept up to date as the map changes, so searches
+can treat those regions as plain open ground.
+For Jump Point Search, each cell also keeps how many steps it is in each
+straight direction to the next cell a jump has to stop at (see
+IsJumpPoint), or to the last cell before a blocked one, so a straight
+jump is a single lookup. These are kept up to date along the rows and
+columns through each cell that changes.
+
+Neighbours are numbered clockwise from the top-left:
+[0][1][2]
+[7][X][3]
+[6][5][4]
+
+A grid can be saved to and loaded from a binary map. The map is a
+MapHeader followed by the cost table and each per-cell array exactly as
+they are laid out in memory (border included, in the machine's byte
+order), so loading one is little more than a copy of each array.
+Only the colours, blocked cells and costs are stored; the uniform cells
+and jumps are worked out again from them on loading, so a map edited by
+hand can't leave them wrong.
+-------------------------------*/
+
+// The header at the start of a binary map, followed by the arrays listed in PathGrid::Load
+struct MapHeader
+{
+	char magic[4];							// Always "PTVM"
+	unsigned int version;					// The format version, which must match PathGrid::MAP_VERSION
+	int width;								// The width of the grid, excluding the border
+	int height;								// The height of the grid, excluding the border
+	int costCount;							// The number of entries in the cost table
+	unsigned char standardIds[8];			// The cost table index of the standard cost in each direction
+	unsigned char reserved[4];				// Unused, keeping the arrays that follow 4-byte aligned
+};
+
+class PathGrid
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the PathGrid with the specified size, with every cell unblocked and every cost set to the specified values
+	PathGrid(int width, int height, unsigned int colour, int straightCost, int diagonalCost)
+	{
+		// Store dimensions, including the border
+		this->width = width;
+		this->height = height;
+		stride = width + 2;
+		cellCount = stride * (height + 2);
+
+		// Store neighbour offsets, matching the layout above (y increases upwards)
+		const int offsetX[NEIGHBOURS] = { -1, 0, 1, 1, 1, 0, -1, -1 };
+		const int offsetY[NEIGHBOURS] = { 1, 1, 1, 0, -1, -1, -1, 0 };
+		for (int n = 0; n < NEIGHBOURS; n++)
+			offsets[n] = offsetX[n] + (offsetY[n] * stride);
+
+		// Store the standard cost in each direction (diagonals are even)
+		costCount = 0;
+		version = 0;
+		for (int n = 0; n < NEIGHBOURS; n++)
+			standardIds[n] = GetCostId((n % 2 == 0) ? diagonalCost : straightCost);
+
+		// Allocate arrays
+		colours.assign(cellCount, colour);
+		costIds.assign(cellCount * NEIGHBOURS, 0);
+		blocked.assign((cellCount + 31) / 32, 0);
+
+		// Set the standard costs, and block the border
+		for (int cell = 0; cell < cellCount; cell++)
+		{
+			for (int n = 0; n < NEIGHBOURS; n++)
+				costIds[(cell * NEIGHBOURS) + n] = standardIds[n];
+			if (!IsInside(cell))
+				SetBit(blocked, cell, true);
+		}
+
+		// Every cell not touching the border starts uniform
+		BuildUniform();
+		BuildJumps();
+	}
+
+	/* ---- INDEX FUNCTIONS ---- */
+	// Returns the cell index at the specified grid position (which may be one cell outside the grid, in the border)
+	int GetIndex(int x, int y) const
+	{
+		return (x + 1) + ((y + 1) * stride);
+	}
+	int GetX(int cell) const // Returns the x position in the grid of the specified cell
+	{
+		return (cell % stride) - 1;
+	}
+	int GetY(int cell) const // Returns the y position in the grid of the specified cell
+	{
+		return (cell / stride) - 1;
+	}
+	// Returns the cell index of the specified neighbour, which will be a blocked border cell if outside the grid
+	int GetNeighbour(int cell, int n) const
+	{
+		return cell + offsets[n];
+	}
+	// Returns true if the specified grid position is inside the grid
+	bool IsInside(int x, int y) const
+	{
+		return x >= 0 && x < width && y >= 0 && y < height;
+	}
+	// Returns true if the specified cell is inside the grid, rather than in the border
+	bool IsInside(int cell) const
+	{
+		return IsInside(GetX(cell), GetY(cell));
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	// Returns the cost of moving from the specified cell to its specified neighbour
+	int GetCost(int cell, int n) const
+	{
+		return costTable[costIds[(cell * NEIGHBOURS) + n]];
+	}
+	// Returns true if the specified cell cannot be traversed
+	bool IsBlocked(int cell) const
+	{
+		return GetBit(blocked, cell);
+	}
+	// Returns true if the specified cell and all of its neighbours are unblocked and only use the standard costs
+	bool IsUniform(int cell) const
+	{
+		return GetBit(uniform, cell);
+	}
+	// Returns true if the specified cell is unblocked and only uses the standard costs
+	bool IsStandard(int cell) const
+	{
+		if (IsBlocked(cell))
+			return false;
+		for (int n = 0; n < NEIGHBOURS; n++)
+		{
+			if (costIds[(cell * NEIGHBOURS) + n] != standardIds[n])
+				return false;
+		}
+		return true;
+	}
+	unsigned int GetColour(int cell) const // Returns the colour of the specified cell
+	{
+		return colours[cell];
+	}
+	int GetWidth() const // Returns the width of the grid, excluding the border
+	{
+		return width;
+	}
+	int GetHeight() const // Returns the height of the grid, excluding the border
+	{
+		return height;
+	}
+	int GetCellCount() const // Returns the number of cells, including the border
+	{
+		return cellCount;
+	}
+	int GetMinCost() const // Returns the lowest edge cost the grid has used, which is never more than any move costs
+	{
+		return minCost;
+	}
+	unsigned int GetVersion() const // Returns a number that changes whenever a cell's blocked flag or costs change, so results can tell they are stale
+	{
+		return version;
+	}
+
+	/* ---- JUMP FUNCTIONS ---- */
+	// Returns true if a jump moving in the specified direction has to stop at the specified cell, as the path might turn there
+	// That is if the cell uses its own costs, or it has forced neighbours (see GetForcedNeighbours)
+	bool IsJumpPoint(int cell, int n) const
+	{
+		if (IsUniform(cell))
+			return false;
+		return !IsStandard(cell) || GetForcedNeighbours(cell, n) != 0;
+	}
+	// Returns a bit for each neighbour only reached cheaply through the specified cell when arriving in the specified direction,
+	// as a cell beside it that doesn't use the standard costs is in the way
+	unsigned int GetForcedNeighbours(int cell, int n) const
+	{
+		if (IsUniform(cell))
+			return 0;
+
+		// Moving straight, a cell to either side hides the cell diagonally ahead of it
+		// Moving diagonally, a cell behind either straight part hides the cell beyond it
+		int isDiagonal = (n % 2 == 0) ? 1 : 0;
+		int hidingSides[2] = { (n + 2 + isDiagonal) % NEIGHBOURS, (n + 6 - isDiagonal) % NEIGHBOURS };
+		int hiddenSides[2] = { (n + 1 + isDiagonal) % NEIGHBOURS, (n + 7 - isDiagonal) % NEIGHBOURS };
+		unsigned int forced = 0;
+		for (int i = 0; i < 2; i++)
+		{
+			if (!IsStandard(GetNeighbour(cell, hidingSides[i])) && !IsBlocked(GetNeighbour(cell, hiddenSides[i])))
+				forced |= 1u << hiddenSides[i];
+		}
+		return forced;
+	}
+	// Moves from the specified cell in the specified straight direction until reaching a jump point or the specified end cell
+	// Returns that cell and stores the number of steps taken, or returns -1 if a blocked cell is reached first
+	int JumpStraight(int cell, int n, int endCell, int& steps) const
+	{
+		// Positive jumps reach a jump point in that many steps, otherwise a blocked cell is reached after that many steps (negated)
+		int jump = straightJumps[(cell * STRAIGHT_NEIGHBOURS) + (n / 2)];
+		int freeSteps = (jump > 0) ? jump : -jump;
+
+		// Stop early at the end cell if it lies along the way
+		int difference = endCell - cell;
+		int endSteps = difference / offsets[n];
+		if (endSteps > 0 && endSteps <= freeSteps && endSteps * offsets[n] == difference && (abs(offsets[n]) == stride || GetY(endCell) == GetY(cell)))
+		{
+			steps = endSteps;
+			return endCell;
+		}
+
+		steps = jump;
+		return (jump > 0) ? cell + (jump * offsets[n]) : -1;
+	}
+
+	/* ---- LINE FUNCTIONS ---- */
+	// Returns the cost of moving in a straight line between the specified cells (see WalkLine)
+	// Returns -1 if the line enters a blocked cell or costs more than the specified limit
+	int GetLineCost(int fromCell, int toCell, int maxCost) const
+	{
+		int cost = 0;
+		bool isClear = WalkLine(fromCell, toCell, [&](int cell, int n)
+		{
+			cost += GetCost(cell, n);
+			return cost <= maxCost && !IsBlocked(GetNeighbour(cell, n));
+		});
+		return isClear ? cost : -1;
+	}
+	// Moves in a straight line from the first specified cell to the second, as closely as straight and diagonal moves allow
+	// Calls the specified function with each cell moved from and the neighbour index moved in, stopping early if it returns false
+	// Returns true if the line was walked to the end
+	template<typename Visit>
+	bool WalkLine(int fromCell, int toCell, Visit visit) const
+	{
+		int dX = GetX(toCell) - GetX(fromCell);
+		int dY = GetY(toCell) - GetY(fromCell);
+		int stepX = (dX > 0) - (dX < 0);
+		int stepY = (dY > 0) - (dY < 0);
+		int major = std::max(abs(dX), abs(dY));
+		int minor = std::min(abs(dX), abs(dY));
+
+		// Step along the longer axis every move, and diagonally whenever the shorter axis has built up a full cell (Bresenham's line)
+		int straight = (abs(dX) >= abs(dY)) ? GetDirection(stepX, 0) : GetDirection(0, stepY);
+		int diagonal = GetDirection(stepX, stepY);
+		int error = major / 2;
+		int cell = fromCell;
+		for (int i = 0; i < major; i++)
+		{
+			int n = straight;
+			error -= minor;
+			if (error < 0)
+			{
+				error += major;
+				n = diagonal;
+			}
+
+			if (!visit(cell, n))
+				return false;
+			cell = GetNeighbour(cell, n);
+		}
+		return true;
+	}
+
+	/* ---- SETTER FUNCTIONS ---- */
+	// Sets the colour and the cost to each neighbour of the cell at the specified grid position
+	void SetNode(int x, int y, unsigned int colour, int cost0, int cost1, int cost2, int cost3, int cost4, int cost5, int cost6, int cost7)
+	{
+		int cell = GetIndex(x, y);
+		const int costs[NEIGHBOURS] = { cost0, cost1, cost2, cost3, cost4, cost5, cost6, cost7 };
+
+		colours[cell] = colour;
+		for (int n = 0; n < NEIGHBOURS; n++)
+			costIds[(cell * NEIGHBOURS) + n] = GetCostId(costs[n]);
+		UpdateUniform(cell);
+		UpdateJumps(cell);
+		version++;
+	}
+	// Sets the cost of moving from the specified cell to its specified neighbour
+	void SetCost(int cell, int n, int cost)
+	{
+		costIds[(cell * NEIGHBOURS) + n] = GetCostId(cost);
+		UpdateUniform(cell);
+		UpdateJumps(cell);
+		version++;
+	}
+	void SetColour(int cell, unsigned int colour) // Sets the colour of the specified cell
+	{
+		colours[cell] = colour;
+	}
+	// Sets whether the specified cell can be traversed (border cells are always blocked)
+	void SetBlocked(int cell, bool isBlocked)
+	{
+		assert(IsInside(cell) && "Border cells cannot be changed");
+		SetBit(blocked, cell, isBlocked);
+		UpdateUniform(cell);
+		UpdateJumps(cell);
+		version++;
+	}
+
+	/* ---- MAP FUNCTIONS ---- */
+	// Replaces the grid with the binary map in the specified memory, returning true if successful, otherwise false
+	// The grid is left unchanged if the map is invalid
+	bool Load(const unsigned char* data, size_t size)
+	{
+		// Check the header
+		MapHeader header;
+		if (size < sizeof(MapHeader))
+			return false;
+		memcpy(&header, data, sizeof(MapHeader));
+		if (memcmp(header.magic, "PTVM", 4) != 0 || header.version != MAP_VERSION)
+			return false;
+		if (header.width <= 0 || header.height <= 0 || header.width > MAX_MAP_SIZE || header.height > MAX_MAP_SIZE)
+			return false;
+		if (header.costCount <= 0 || header.costCount > MAX_COSTS)
+			return false;
+
+		// Check the size matches the arrays the header describes
+		size_t newCellCount = (size_t)(header.width + 2) * (header.height + 2);
+		size_t bitCount = (newCellCount + 31) / 32;
+		size_t costsSize = header.costCount * sizeof(int);
+		size_t coloursSize = newCellCount * sizeof(unsigned int);
+		size_t bitsSize = bitCount * sizeof(unsigned int);
+		size_t costIdsSize = newCellCount * NEIGHBOURS;
+		if (size != sizeof(MapHeader) + costsSize + coloursSize + bitsSize + costIdsSize)
+			return false;
+		for (int n = 0; n < NEIGHBOURS; n++)
+		{
+			if (header.standardIds[n] >= header.costCount)
+				return false;
+		}
+
+		// Searches and flow fields divide by and add up costs, so every cost must be positive, and every edge must point into the table
+		const unsigned char* costsData = data + sizeof(MapHeader);
+		const unsigned char* costIdsData = data + size - costIdsSize;
+		for (int i = 0; i < header.costCount; i++)
+		{
+			int cost;
+			memcpy(&cost, costsData + (i * sizeof(int)), sizeof(int));
+			if (cost <= 0)
+				return false;
+		}
+		for (size_t i = 0; i < costIdsSize; i++)
+		{
+			if (costIdsData[i] >= header.costCount)
+				return false;
+		}
+
+		// Copy the header values
+		width = header.width;
+		height = header.height;
+		stride = width + 2;
+		cellCount = (int)newCellCount;
+		const int offsetX[NEIGHBOURS] = { -1, 0, 1, 1, 1, 0, -1, -1 };
+		const int offsetY[NEIGHBOURS] = { 1, 1, 1, 0, -1, -1, -1, 0 };
+		for (int n = 0; n < NEIGHBOURS; n++)
+		{
+			offsets[n] = offsetX[n] + (offsetY[n] * stride);
+			standardIds[n] = header.standardIds[n];
+		}
+
+		// Copy each array in the order they were saved
+		const unsigned char* read = data + sizeof(MapHeader);
+		costCount = header.costCount;
+		memcpy(costTable, read, costsSize);
+		read += costsSize;
+		colours.resize(newCellCount);
+		memcpy(colours.data(), read, coloursSize);
+		read += coloursSize;
+		blocked.resize(bitCount);
+		memcpy(blocked.data(), read, bitsSize);
+		read += bitsSize;
+		costIds.resize(costIdsSize);
+		memcpy(costIds.data(), read, costIdsSize);
+
+		// Searches rely on the border being blocked, so never trust the map for it
+		for (int x = -1; x <= width; x++)
+		{
+			BlockBorder(GetIndex(x, -1));
+			BlockBorder(GetIndex(x, height));
+		}
+		for (int y = 0; y < height; y++)
+		{
+			BlockBorder(GetIndex(-1, y));
+			BlockBorder(GetIndex(width, y));
+		}
+
+		// Find the lowest cost
+		minCost = costTable[0];
+		for (int i = 1; i < costCount; i++)
+			minCost = (costTable[i] < minCost) ? costTable[i] : minCost;
+
+		// Work out which cells are uniform from the map as loaded, rather than trusting a copy of them
+		BuildUniform();
+		BuildJumps();
+		version++;
+		return true;
+	}
+	// Stores the grid as a binary map in the specified buffer, which can be written to a file and loaded with Load
+	void Save(std::vector<unsigned char>& data) const
+	{
+		MapHeader header = {};
+		memcpy(header.magic, "PTVM", 4);
+		header.version = MAP_VERSION;
+		header.width = width;
+		header.height = height;
+		header.costCount = costCount;
+		for (int n = 0; n < NEIGHBOURS; n++)
+			header.standardIds[n] = standardIds[n];
+
+		// Append the header and each array in the order Load expects
+		data.clear();
+		Append(data, &header, sizeof(MapHeader));
+		Append(data, costTable, costCount * sizeof(int));
+		Append(data, colours.data(), colours.size() * sizeof(unsigned int));
+		Append(data, blocked.data(), blocked.size() * sizeof(unsigned int));
+		Append(data, costIds.data(), costIds.size());
+	}
+
+	/* ---- CONSTANTS ---- */
+	static const int NEIGHBOURS = 8;		// The number of neighbours each cell has
+	static const int MAX_COSTS = 256;		// The number of distinct costs a byte can index
+	static const int MAX_MAP_SIZE = 16384;	// The most cells a binary map can have along either side, so its cell count fits in an int
+	static const int STRAIGHT_NEIGHBOURS = 4;	// The number of straight neighbours each cell keeps a jump for
+	static const unsigned int MAP_VERSION = 2;	// The binary map format version, raised whenever the layout changes
+
+private:
+	// Returns true if the specified cell and all of its neighbours are standard cells (see IsStandard)
+	bool IsUniformCell(int cell) const
+	{
+		if (!IsInside(cell) || !IsStandard(cell))
+			return false;
+		for (int n = 0; n < NEIGHBOURS; n++)
+		{
+			if (!IsStandard(GetNeighbour(cell, n)))
+				return false;
+		}
+		return true;
+	}
+	// Recalculates whether every cell is uniform
+	void BuildUniform()
+	{
+		uniform.assign((cellCount + 31) / 32, 0);
+		for (int cell = 0; cell < cellCount; cell++)
+			SetBit(uniform, cell, IsUniformCell(cell));
+	}
+	// Recalculates the straight jumps of every cell
+	void BuildJumps()
+	{
+		straightJumps.assign(cellCount * STRAIGHT_NEIGHBOURS, 0);
+		for (int n = 1; n < NEIGHBOURS; n += 2)
+		{
+			// Work back along each row or column from its last cell in that direction
+			for (int cell = 0; cell < cellCount; cell++)
+			{
+				if (IsInside(cell) && !IsInside(GetNeighbour(cell, n)))
+					UpdateJumpLine(cell, n, true);
+			}
+		}
+	}
+	// Recalculates the straight jumps of the cells that could have changed with the specified cell, after it and its neighbours have been updated
+	void UpdateJumps(int cell)
+	{
+		// Changing a cell can change whether any of its neighbours are jump points, so update the three rows and columns through them
+		for (int n = 1; n < NEIGHBOURS; n += 2)
+		{
+			int across = offsets[(n + 2) % NEIGHBOURS];
+			for (int side = -1; side <= 1; side++)
+				UpdateJumpLine(cell + (side * across) + offsets[n], n, false);
+		}
+	}
+	// Recalculates the straight jumps in the specified direction of the specified cell and those before it, working backwards
+	// Unless the whole line is asked for, this stops once past the three changed cells (and the one before) and a jump is unchanged
+	void UpdateJumpLine(int last, int n, bool isWholeLine)
+	{
+		int index = n / 2;
+		for (int cell = last, i = 0; ; cell -= offsets[n], i++)
+		{
+			// Skip the first cell if it's in the border, otherwise stop on reaching the border
+			if (!IsInside(cell))
+			{
+				if (i == 0)
+					continue;
+				return;
+			}
+
+			int next = GetNeighbour(cell, n);
+			int nextJump = straightJumps[(next * STRAIGHT_NEIGHBOURS) + index];
+			int jump =
+				IsBlocked(next) ? 0 :
+				IsJumpPoint(next, n) ? 1 :
+				(nextJump > 0) ? nextJump + 1 : nextJump - 1;
+
+			if (!isWholeLine && i >= 4 && jump == straightJumps[(cell * STRAIGHT_NEIGHBOURS) + index])
+				return;
+			straightJumps[(cell * STRAIGHT_NEIGHBOURS) + index] = jump;
+		}
+	}
+	// Recalculates whether the specified cell and its neighbours are uniform, after the cell has changed
+	void UpdateUniform(int cell)
+	{
+		SetBit(uniform, cell, IsUniformCell(cell));
+		for (int n = 0; n < NEIGHBOURS; n++)
+		{
+			int neighbour = GetNeighbour(cell, n);
+			SetBit(uniform, neighbour, IsUniformCell(neighbour));
+		}
+	}
+	// Returns the neighbour index of a move by the specified steps (each -1, 0 or 1) on each axis
+	static int GetDirection(int stepX, int stepY)
+	{
+		const int directions[3][3] =
+		{
+			{ 6, 7, 0 },	// stepX = -1, for stepY = -1, 0, 1
+			{ 5, -1, 1 },	// stepX = 0
+			{ 4, 3, 2 }		// stepX = 1
+		};
+		return directions[stepX + 1][stepY + 1];
+	}
+	// Returns the specified bit of the specified bit array
+	static bool GetBit(const std::vector<unsigned int>& bits, int index)
+	{
+		return (bits[index >> 5] & (1u << (index & 31))) != 0;
+	}
+	// Sets the specified bit of the specified bit array
+	static void SetBit(std::vector<unsigned int>& bits, int index, bool value)
+	{
+		if (value)
+			bits[index >> 5] |= (1u << (index & 31));
+		else
+			bits[index >> 5] &= ~(1u << (index & 31));
+	}
+
+	void BlockBorder(int cell) // Marks the specified border cell as blocked
+	{
+		SetBit(blocked, cell, true);
+	}
+	// Appends the specified bytes to the end of the specified buffer
+	static void Append(std::vector<unsigned char>& data, const void* bytes, size_t size)
+	{
+		const unsigned char* start = (const unsigned char*)bytes;
+		data.insert(data.end(), start, start + size);
+	}
+
+	// Returns the index of the specified cost in the cost table, adding it if not yet used
+	unsigned char GetCostId(int cost)
+	{
+		for (int i = 0; i < costCount; i++)
+		{
+			if (costTable[i] == cost)
+				return (unsigned char)i;
+		}
+
+		assert(costCount < MAX_COSTS && "Too many distinct costs");
+		if (costCount == 0 || cost < minCost)
+			minCost = cost;
+		costTable[costCount] = cost;
+		return (unsigned char)(costCount++);
+	}
+
+	/* ---- VARIABLES ---- */
+	int width;								// The width of the grid, excluding the border
+	int height;								// The height of the grid, excluding the border
+	int stride;								// The distance between rows, including the border
+	int cellCount;							// The number of cells, including the border
+	int offsets[NEIGHBOURS];				// The index offset to each neighbour
+
+	std::vector<unsigned int> colours;		// The colour of each cell
+	std::vector<unsigned char> costIds;		// The cost table index of each edge, NEIGHBOURS per cell
+	std::vector<unsigned int> blocked;		// Whether each cell is blocked, one bit per cell
+	std::vector<unsigned int> uniform;		// Whether each cell is uniform, one bit per cell
+	std::vector<int> straightJumps;			// The steps to the next jump point in each straight direction, or to the last cell before a blocked one (negated)
+	unsigned char standardIds[NEIGHBOURS];	// The cost table index of the standard cost in each direction
+	int costTable[MAX_COSTS];				// The distinct edge costs used by the grid
+	int costCount;							// The number of entries used in the cost table
+	int minCost;							// The lowest cost in the cost table
+	unsigned int version;					// Incremented whenever a cell's blocked flag or costs change
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <chrono>
+#include <climits>
+#include "Pathfinder.h"
+
+/* ------------------------------
+PATHQUERY CLASS
+
+The PathQuery runs a single search a little at a time, so long searches
+can be spread across several frames instead of stalling one.
+Each frame, Step expands up to a set number of cells, or StepFor keeps
+expanding until a time budget runs out, and both return the query's
+SearchStatus. Once Found, the path is read from the query's
+SearchContext as with any other search (see Pathfinder::WritePath).
+
+The whole search is kept in the query's own SearchContext, so any number
+of queries can be in progress at once. If the Pathfinder's map changes
+while a query is in progress, its next step starts the search again
+rather than finishing with a stale path. A query that's no longer wanted
+(such as when its agent picks a new destination) can be cancelled, and
+a new search can be started on the same query at any time.
+-------------------------------*/
+
+class PathQuery
+{
+public:
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the PathQuery to search the specified Pathfinder's map
+	PathQuery(const Pathfinder& pathfinder) : pathfinder(pathfinder), context(pathfinder.GetGrid().GetCellCount())
+	{
+	}
+
+	/* ---- SEARCH FUNCTIONS ---- */
+	// Starts a search between the two specified world positions using the specified SearchMode, replacing any search in progress
+	SearchStatus Start(Vector2 start, Vector2 end, SearchMode mode = SearchMode::AStar)
+	{
+		return Start(pathfinder.GetNodeByPos(start), pathfinder.GetNodeByPos(end), mode);
+	}
+	// Starts a search between the two specified cells using the specified SearchMode, replacing any search in progress
+	SearchStatus Start(int nodeStart, int nodeEnd, SearchMode mode = SearchMode::AStar)
+	{
+		return pathfinder.StartSearch(nodeStart, nodeEnd, context, mode);
+	}
+	// Continues the search, expanding no more than the specified number of cells, and returns its SearchStatus
+	SearchStatus Step(int maxExpansions)
+	{
+		return pathfinder.ContinueSearch(context, maxExpansions);
+	}
+	// Continues the search until it finishes or the specified number of microseconds have passed, and returns its SearchStatus
+	// The time is checked every EXPANSIONS_PER_CHECK cells, so the budget can be overrun by the time those take
+	SearchStatus StepFor(double microseconds)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		auto getMicroseconds = [&]() { return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count(); };
+
+		SearchStatus status = pathfinder.ContinueSearch(context, EXPANSIONS_PER_CHECK);
+		while (status == SearchStatus::Searching && getMicroseconds() < microseconds)
+			status = pathfinder.ContinueSearch(context, EXPANSIONS_PER_CHECK);
+		return status;
+	}
+	// Stops the search in progress, leaving the query Cancelled until a new search is started
+	void Cancel()
+	{
+		if (context.status == SearchStatus::Searching)
+			context.status = SearchStatus::Cancelled;
+	}
+
+	/* ---- GETTER FUNCTIONS ---- */
+	SearchStatus GetStatus() const // Returns the progress of the current search
+	{
+		return context.status;
+	}
+	bool IsDone() const // Returns true if the current search has finished, whether or not a path was found
+	{
+		return context.status != SearchStatus::Searching;
+	}
+	// Returns the SearchContext holding the search, and once Found, its path
+	const SearchContext& GetContext() const
+	{
+		return context;
+	}
+
+	/* ---- CONSTANTS ---- */
+	static const int EXPANSIONS_PER_CHECK = 64;		// The number of cells StepFor expands between checks of the time
+
+private:
+	/* ---- VARIABLES ---- */
+	const Pathfinder& pathfinder;		// The Pathfinder whose map is searched
+	SearchContext context;				// The state of the current search, kept between steps
+};
@@ -1,50 +1,53 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include "Pathfinder.h"
+#include "MappedFile.h"
 
 /* ---- CONSTRUCTORS & DESTRUCTORS ---- */
-// Initialize the Pathfinder object and fill with GraphNodes
-Pathfinder::Pathfinder()
+// Initialize the Pathfinder object with the binary map at the specified path, or the built-in train network if none is given or it can't be loaded
+Pathfinder::Pathfinder(const char* mapPath) :
+	grid(0, 0, COL_BLACK, WALK, WALKA),
+	defaultContext(grid.GetCellCount())
 {
-	// Create all GraphNodes in a grid and initialize them
-	for (int y = 0; y < GRID_H; y++)
-	{
-		for (int x = 0; x < GRID_W; x++)
-		{
-			// Create GraphNode
-			nodes[x][y] = new GraphNode();
-
-			// Initialize variables
-			nodes[x][y]->indexX = x;											// Index of the node in the grid
-			nodes[x][y]->indexY = y;											// "
-			nodes[x][y]->position.x = (float)(POS_XOFFSET + (x * NODE_W));		// World position
-			nodes[x][y]->position.y = (float)(POS_YOFFSET + (y * NODE_H));		// "
-			nodes[x][y]->prev = nullptr;										// The previous node in the path (when found)
-			nodes[x][y]->scoreG = 0;											// Score for A* algorithm
-			nodes[x][y]->scoreF = 0;											// "
-			nodes[x][y]->scoreH = 0;											// "
-			nodes[x][y]->isBlocked = false;										// Whether or not the node can be traversed through
-			nodes[x][y]->colour = COL_BLACK;									// The colour of the node
-		}
-	}
+	// Start from an empty grid, so a map is copied straight in without laying out the default grid first
+	if (mapPath != nullptr && LoadMap(mapPath))
+		return;
 
-	// Connect all GraphNodes to their neighbours
-	// [0][1][2]
-	// [7][X][3]
-	// [6][5][4]
-	for (int y = 0; y < GRID_H; y++)
-	{
-		for (int x = 0; x < GRID_W; x++)
-		{
-			for (int n = 0; n < NEIGHBOUR_COUNT; n++)
-			{
-				// Set neighbour
-				nodes[x][y]->neighbours[n] = GetNeighbour(x, y, n);
-				
-				// Set cost to neighbour depending upon diagonal or straight
-				nodes[x][y]->costs[n] = (n == 0 || n == 2 || n == 4 || n == 6) ? WALKA : WALK;
-			}
-		}
-	}
+	grid = PathGrid(GRID_W, GRID_H, COL_BLACK, WALK, WALKA);
+	defaultContext = SearchContext(grid.GetCellCount());
+	BuildTrainNetwork();
+}
+
+/* ---- MAP FUNCTIONS ---- */
+// Replaces the grid with the binary map at the specified path, returning true if successful, otherwise false
+bool Pathfinder::LoadMap(const char* path)
+{
+	// Map the file and copy the grid straight out of it
+	MappedFile file;
+	if (!file.Open(path) || !grid.Load(file.GetData(), file.GetSize()))
+		return false;
 
+	// The map may be a different size, so resize the default search state to match, and drop landmarks from the old map
+	defaultContext = SearchContext(grid.GetCellCount());
+	landmarks.Clear();
+	return true;
+}
+// Writes the grid as a binary map to the specified path, returning true if successful, otherwise false
+bool Pathfinder::SaveMap(const char* path) const
+{
+	std::vector<unsigned char> data;
+	grid.Save(data);
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+		return false;
+	bool isWritten = fwrite(data.data(), 1, data.size(), file) == data.size();
+	return (fclose(file) == 0) && isWritten;
+}
+// Lays out the metropolitan train network on the walkable grid (used when no map is loaded, and by MapConverter to create one)
+void Pathfinder::BuildTrainNetwork()
+{
 #pragma region PTV Train Network
 	/*
 	This sets the nodes in the pathfinder to represent the metropolitan
@@ -68,199 +71,199 @@ Pathfinder::Pathfinder()
 	/* --- TRAIN LINES --- */
 	
 	// Red - South Morang & Hurstbridge Line
-	nodes[75][46]->SetNode(COL_RED, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);					// Join with City Loop
-	nodes[76][46]->SetNode(COL_RED, NA, NA, TRAINA, NA, NA, NA, NA, TRAIN);
+	grid.SetNode(75, 46, COL_RED, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);					// Join with City Loop
+	grid.SetNode(76, 46, COL_RED, NA, NA, TRAINA, NA, NA, NA, NA, TRAIN);
 	for (int i = 0; i < 8; i++)
-		nodes[77 + i][47 + i]->SetNode(COL_RED, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
-	nodes[86][56]->SetNode(COL_RED, NA, TRAIN, TRAINA, NA, NA, NA, TRAINA, NA);				// South Morang & Hurstridge Line split
+		grid.SetNode(77 + i, 47 + i, COL_RED, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
+	grid.SetNode(86, 56, COL_RED, NA, TRAIN, TRAINA, NA, NA, NA, TRAINA, NA);				// South Morang & Hurstridge Line split
 	for (int i = 0; i < 10; i++)															// South Morang Line...
-		nodes[86][57 + i]->SetNode(COL_RED, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
-	nodes[86][67]->SetNode(COL_RED, NA, NA, TRAINA, NA, NA, TRAIN, NA, NA);
+		grid.SetNode(86, 57 + i, COL_RED, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
+	grid.SetNode(86, 67, COL_RED, NA, NA, TRAINA, NA, NA, TRAIN, NA, NA);
 	for (int i = 0; i < 5; i++)
-		nodes[87 + i][68+ i]->SetNode(COL_RED, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
-	nodes[92][73]->SetNode(COL_RED, NA, NA, NA, TRAIN, NA, NA, TRAINA, NA);
+		grid.SetNode(87 + i, 68+ i, COL_RED, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
+	grid.SetNode(92, 73, COL_RED, NA, NA, NA, TRAIN, NA, NA, TRAINA, NA);
 	for (int i = 0; i < 9; i++)
-		nodes[93 + i][73]->SetNode(COL_RED, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+		grid.SetNode(93 + i, 73, COL_RED, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
 	for (int i = 0; i < 10; i++)															// Hurstbridge Line...
-		nodes[87 + i][57 + i]->SetNode(COL_RED, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
-	nodes[97][67]->SetNode(COL_RED, NA, NA, NA, TRAIN, NA, NA, TRAINA, NA);
+		grid.SetNode(87 + i, 57 + i, COL_RED, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
+	grid.SetNode(97, 67, COL_RED, NA, NA, NA, TRAIN, NA, NA, TRAINA, NA);
 	for (int i = 0; i < 25; i++)
-		nodes[98 + i][67]->SetNode(COL_RED, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+		grid.SetNode(98 + i, 67, COL_RED, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
 
 	// Yellow - Sunbury, Craigieburn & Upfield Line
 	for (int i = 0; i < 8; i++)																// Sunbury Line...
-		nodes[40][66 - i]->SetNode(COL_YELLOW, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
-	nodes[40][58]->SetNode(COL_YELLOW, NA, TRAIN, NA, NA, TRAINA, NA, NA, NA);
-	nodes[41][57]->SetNode(COL_YELLOW, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
+		grid.SetNode(40, 66 - i, COL_YELLOW, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
+	grid.SetNode(40, 58, COL_YELLOW, NA, TRAIN, NA, NA, TRAINA, NA, NA, NA);
+	grid.SetNode(41, 57, COL_YELLOW, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
 	for (int i = 0; i < 11; i++)
-		nodes[43 + i][56]->SetNode(COL_YELLOW, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+		grid.SetNode(43 + i, 56, COL_YELLOW, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
 	for (int i = 0; i < 18; i++)															// Craigieburn Line...
-		nodes[56][79 - i]->SetNode(COL_YELLOW, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
-	nodes[56][61]->SetNode(COL_YELLOW, NA, TRAIN, NA, NA, TRAINA, NA, NA, NA);
+		grid.SetNode(56, 79 - i, COL_YELLOW, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
+	grid.SetNode(56, 61, COL_YELLOW, NA, TRAIN, NA, NA, TRAINA, NA, NA, NA);
 	for (int i = 0; i < 4; i++)
-		nodes[57 + i][60 - i]->SetNode(COL_YELLOW, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
+		grid.SetNode(57 + i, 60 - i, COL_YELLOW, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
 	for (int i = 0; i < 10; i++)															// Upfield Line...
-		nodes[69][75 - i]->SetNode(COL_YELLOW, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
-	nodes[69][65]->SetNode(COL_YELLOW, NA, TRAIN, NA, NA, NA, NA, TRAINA, NA);
+		grid.SetNode(69, 75 - i, COL_YELLOW, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
+	grid.SetNode(69, 65, COL_YELLOW, NA, TRAIN, NA, NA, NA, NA, TRAINA, NA);
 	for (int i = 0; i < 5; i++)
-		nodes[68 - i][64 - i]->SetNode(COL_YELLOW, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
-	nodes[63][59]->SetNode(COL_YELLOW, NA, NA, TRAINA, NA, NA, TRAIN, NA, NA);
+		grid.SetNode(68 - i, 64 - i, COL_YELLOW, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
+	grid.SetNode(63, 59, COL_YELLOW, NA, NA, TRAINA, NA, NA, TRAIN, NA, NA);
 	for (int i = 0; i < 3; i++)
-		nodes[63][58 - i]->SetNode(COL_YELLOW, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
+		grid.SetNode(63, 58 - i, COL_YELLOW, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
 
 	// Blue - Lilydale, Melbrave, Alamein & Glen Waverley Line
 	for (int i = 0; i < 7; i++)
-		nodes[78 + i][43]->SetNode(COL_BLUE, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
-	nodes[86][43]->SetNode(COL_BLUE, NA, NA, TRAINA, NA, TRAINA, NA, NA, TRAIN);
+		grid.SetNode(78 + i, 43, COL_BLUE, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+	grid.SetNode(86, 43, COL_BLUE, NA, NA, TRAINA, NA, TRAINA, NA, NA, TRAIN);
 	for (int i = 0; i < 17; i++)															// Lilydale/Belgrave Line...
-		nodes[87 + i][44 + i]->SetNode(COL_BLUE, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
-	nodes[104][61]->SetNode(COL_BLUE, NA, NA, NA, TRAIN, NA, NA, TRAINA, NA);
+		grid.SetNode(87 + i, 44 + i, COL_BLUE, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
+	grid.SetNode(104, 61, COL_BLUE, NA, NA, NA, TRAIN, NA, NA, TRAINA, NA);
 	for (int i = 0; i < 24; i++)
-		nodes[105 + i][61]->SetNode(COL_BLUE, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
-	nodes[118][61]->SetNode(COL_BLUE, NA, NA, NA, TRAIN, TRAINA, NA, NA, TRAIN);
+		grid.SetNode(105 + i, 61, COL_BLUE, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+	grid.SetNode(118, 61, COL_BLUE, NA, NA, NA, TRAIN, TRAINA, NA, NA, TRAIN);
 	for (int i = 0; i < 10; i++)
-		nodes[119 + i][60 - i]->SetNode(COL_BLUE, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
-	nodes[93][50]->SetNode(COL_BLUE, NA, NA, TRAINA, TRAIN, NA, NA, TRAINA, TRAIN);			// Alamein Line...
-	nodes[94][50]->SetNode(COL_BLUE, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
-	nodes[95][50]->SetNode(COL_BLUE, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
-	nodes[96][50]->SetNode(COL_BLUE, NA, NA, NA, NA, TRAINA, NA, NA, TRAIN);
+		grid.SetNode(119 + i, 60 - i, COL_BLUE, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
+	grid.SetNode(93, 50, COL_BLUE, NA, NA, TRAINA, TRAIN, NA, NA, TRAINA, TRAIN);			// Alamein Line...
+	grid.SetNode(94, 50, COL_BLUE, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+	grid.SetNode(95, 50, COL_BLUE, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+	grid.SetNode(96, 50, COL_BLUE, NA, NA, NA, NA, TRAINA, NA, NA, TRAIN);
 	for (int i = 0; i < 7; i++)
-		nodes[97 + i][49 - i]->SetNode(COL_BLUE, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
+		grid.SetNode(97 + i, 49 - i, COL_BLUE, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
 	for (int i = 0; i < 7; i++)																// Glen Waverley Line...
-		nodes[87 + i][42 - i]->SetNode(COL_BLUE, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
-	nodes[94][35]->SetNode(COL_BLUE, TRAINA, NA, NA, TRAIN, NA, NA, NA, NA);
+		grid.SetNode(87 + i, 42 - i, COL_BLUE, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
+	grid.SetNode(94, 35, COL_BLUE, TRAINA, NA, NA, TRAIN, NA, NA, NA, NA);
 	for (int i = 0; i < 17; i++)
-		nodes[95 + i][35]->SetNode(COL_BLUE, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+		grid.SetNode(95 + i, 35, COL_BLUE, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
 
 	// Cyan - Pakenham & Cranbourne Line
 	for (int i = 0; i < 15; i++)
-		nodes[88 + i][32 - i]->SetNode(COL_CYAN, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
-	nodes[104][16]->SetNode(COL_CYAN, TRAINA, NA, NA, TRAIN, NA, TRAIN, NA, NA);			// Cranbourne Line...
-	nodes[104][15]->SetNode(COL_CYAN, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
-	nodes[104][14]->SetNode(COL_CYAN, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
+		grid.SetNode(88 + i, 32 - i, COL_CYAN, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
+	grid.SetNode(104, 16, COL_CYAN, TRAINA, NA, NA, TRAIN, NA, TRAIN, NA, NA);			// Cranbourne Line...
+	grid.SetNode(104, 15, COL_CYAN, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
+	grid.SetNode(104, 14, COL_CYAN, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
 	for (int i = 0; i < 23; i++)															// Pakenham Line...
-		nodes[105 + i][16]->SetNode(COL_CYAN, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+		grid.SetNode(105 + i, 16, COL_CYAN, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
 
 	// Green - Frankston, Werribee & Williamstown Line
 	for (int i = 0; i < 7; i++)																// Werribee Line...
-		nodes[30 + i][51 - i]->SetNode(COL_GREEN, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
+		grid.SetNode(30 + i, 51 - i, COL_GREEN, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
 	for (int i = 0; i < 10; i++)
-		nodes[35 + i][47]->SetNode(COL_GREEN, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
-	nodes[37][44]->SetNode(COL_GREEN, TRAINA, NA, NA, TRAIN, NA, NA, NA, NA);
+		grid.SetNode(35 + i, 47, COL_GREEN, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+	grid.SetNode(37, 44, COL_GREEN, TRAINA, NA, NA, TRAIN, NA, NA, NA, NA);
 	for (int i = 0; i < 4; i++)
-		nodes[38 + i][44]->SetNode(COL_GREEN, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
-	nodes[42][44]->SetNode(COL_GREEN, NA, NA, TRAINA, NA, NA, NA, NA, TRAIN);
+		grid.SetNode(38 + i, 44, COL_GREEN, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+	grid.SetNode(42, 44, COL_GREEN, NA, NA, TRAINA, NA, NA, NA, NA, TRAIN);
 	for (int i = 0; i < 11; i++)
-		nodes[43 + i][45 + i]->SetNode(COL_GREEN, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
-	nodes[45][47]->SetNode(COL_GREEN, NA, NA, TRAINA, NA, NA, TRAIN, TRAINA, TRAIN);		// Williamstown Line...
+		grid.SetNode(43 + i, 45 + i, COL_GREEN, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
+	grid.SetNode(45, 47, COL_GREEN, NA, NA, TRAINA, NA, NA, TRAIN, TRAINA, TRAIN);		// Williamstown Line...
 	for (int i = 0; i < 5; i++)
-		nodes[45][46 - i]->SetNode(COL_GREEN, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
+		grid.SetNode(45, 46 - i, COL_GREEN, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
 	for (int i = 0; i < 19; i++)															// Frankston Line...
-		nodes[87][32 - i]->SetNode(COL_GREEN, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
-	nodes[87][13]->SetNode(COL_GREEN, NA, TRAIN, NA, NA, TRAINA, NA, NA, NA);
-	nodes[88][12]->SetNode(COL_GREEN, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
-	nodes[89][11]->SetNode(COL_GREEN, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
-	nodes[90][10]->SetNode(COL_GREEN, TRAINA, NA, NA, TRAIN, NA, NA, NA, NA);
+		grid.SetNode(87, 32 - i, COL_GREEN, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
+	grid.SetNode(87, 13, COL_GREEN, NA, TRAIN, NA, NA, TRAINA, NA, NA, NA);
+	grid.SetNode(88, 12, COL_GREEN, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
+	grid.SetNode(89, 11, COL_GREEN, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
+	grid.SetNode(90, 10, COL_GREEN, TRAINA, NA, NA, TRAIN, NA, NA, NA, NA);
 	for (int i = 0; i < 9; i++)
-		nodes[91 + i][10]->SetNode(COL_GREEN, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+		grid.SetNode(91 + i, 10, COL_GREEN, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
 
 	// Pink - Sandringham Line
-	nodes[78][40]->SetNode(COL_PINK, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
-	nodes[77][39]->SetNode(COL_PINK, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
-	nodes[76][38]->SetNode(COL_PINK, NA, NA, TRAINA, NA, NA, TRAIN, NA, NA);
+	grid.SetNode(78, 40, COL_PINK, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
+	grid.SetNode(77, 39, COL_PINK, NA, NA, TRAINA, NA, NA, NA, TRAINA, NA);
+	grid.SetNode(76, 38, COL_PINK, NA, NA, TRAINA, NA, NA, TRAIN, NA, NA);
 	for (int i = 0; i < 14; i++)
-		nodes[76][37 - i]->SetNode(COL_PINK, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
+		grid.SetNode(76, 37 - i, COL_PINK, NA, TRAIN, NA, NA, NA, TRAIN, NA, NA);
 
 	// Grey - Multiple Lines
-	nodes[54][56]->SetNode(COL_GREY, NA, NA, NA, TRAIN, NA, NA, TRAINA, TRAIN);				// North-West suburbs...
+	grid.SetNode(54, 56, COL_GREY, NA, NA, NA, TRAIN, NA, NA, TRAINA, TRAIN);				// North-West suburbs...
 	for (int i = 0; i < 6; i++)
-		nodes[55 + i][56]->SetNode(COL_GREY, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
-	nodes[61][56]->SetNode(COL_GREY, TRAINA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
-	nodes[62][56]->SetNode(COL_GREY, NA, NA, NA, NA, TRAINA, NA, NA, TRAIN);
-	nodes[63][55]->SetNode(COL_GREY, TRAINA, TRAIN, NA, NA, TRAINA, NA, NA, NA);
-	nodes[64][54]->SetNode(COL_GREY, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
+		grid.SetNode(55 + i, 56, COL_GREY, NA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+	grid.SetNode(61, 56, COL_GREY, TRAINA, NA, NA, TRAIN, NA, NA, NA, TRAIN);
+	grid.SetNode(62, 56, COL_GREY, NA, NA, NA, NA, TRAINA, NA, NA, TRAIN);
+	grid.SetNode(63, 55, COL_GREY, TRAINA, TRAIN, NA, NA, TRAINA, NA, NA, NA);
+	grid.SetNode(64, 54, COL_GREY, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
 	for (int i = 0; i < 12; i++)															// South-East suburbs...
-		nodes[75 + i][45 - i]->SetNode(COL_GREY, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
-	nodes[77][43]->SetNode(COL_GREY, TRAINA, NA, NA, TRAIN, TRAINA, NA, NA, NA);
-	nodes[79][41]->SetNode(COL_GREY, TRAINA, NA, NA, NA, TRAINA, NA, TRAINA, NA);
-	nodes[87][33]->SetNode(COL_GREY, TRAINA, NA, NA, NA, TRAINA, TRAIN, NA, NA);
+		grid.SetNode(75 + i, 45 - i, COL_GREY, TRAINA, NA, NA, NA, TRAINA, NA, NA, NA);
+	grid.SetNode(77, 43, COL_GREY, TRAINA, NA, NA, TRAIN, TRAINA, NA, NA, NA);
+	grid.SetNode(79, 41, COL_GREY, TRAINA, NA, NA, NA, TRAINA, NA, TRAINA, NA);
+	grid.SetNode(87, 33, COL_GREY, TRAINA, NA, NA, NA, TRAINA, TRAIN, NA, NA);
 
 	// Grey - City Loop (weights to force counter-clockwise around the loop)
-	nodes[66][54]->SetNode(COL_GREY, NA, NA, NA, NA, NA, NA, TRAINA, NA);
+	grid.SetNode(66, 54, COL_GREY, NA, NA, NA, NA, NA, NA, TRAINA, NA);
 	for (int i = 0; i < 6; i++)
-		nodes[67 + i][54]->SetNode(COL_GREY, NA, NA, NA, NA, NA, NA, NA, TRAIN);
-	nodes[73][54]->SetNode(COL_GREY, NA, NA, NA, NA, NA, NA, NA, TRAIN);
-	nodes[74][53]->SetNode(COL_GREY, TRAINA, NA, NA, NA, NA, NA, NA, NA);
-	nodes[75][52]->SetNode(COL_GREY, TRAINA, NA, NA, NA, NA, NA, NA, NA);
+		grid.SetNode(67 + i, 54, COL_GREY, NA, NA, NA, NA, NA, NA, NA, TRAIN);
+	grid.SetNode(73, 54, COL_GREY, NA, NA, NA, NA, NA, NA, NA, TRAIN);
+	grid.SetNode(74, 53, COL_GREY, TRAINA, NA, NA, NA, NA, NA, NA, NA);
+	grid.SetNode(75, 52, COL_GREY, TRAINA, NA, NA, NA, NA, NA, NA, NA);
 	for (int i = 0; i < 4; i++)
-		nodes[75][51 - i]->SetNode(COL_GREY, NA, TRAIN, NA, NA, NA, NA, NA, NA);
-	nodes[75][47]->SetNode(COL_GREY, NA, TRAIN, NA, NA, NA, NA, NA, NA);
-	nodes[74][46]->SetNode(COL_GREY, NA, NA, TRAINA, NA, TRAINA, NA, NA, NA);
-	nodes[73][45]->SetNode(COL_GREY, NA, NA, TRAINA, NA, NA, NA, NA, NA);
+		grid.SetNode(75, 51 - i, COL_GREY, NA, TRAIN, NA, NA, NA, NA, NA, NA);
+	grid.SetNode(75, 47, COL_GREY, NA, TRAIN, NA, NA, NA, NA, NA, NA);
+	grid.SetNode(74, 46, COL_GREY, NA, NA, TRAINA, NA, TRAINA, NA, NA, NA);
+	grid.SetNode(73, 45, COL_GREY, NA, NA, TRAINA, NA, NA, NA, NA, NA);
 	for (int i = 0; i < 6; i++)
-		nodes[67 + i][45]->SetNode(COL_GREY, NA, NA, NA, TRAIN, NA, NA, NA, NA);
-	nodes[66][45]->SetNode(COL_GREY, NA, NA, NA, TRAIN, NA, NA, NA, NA);
-	nodes[65][46]->SetNode(COL_GREY, NA, NA, NA, NA, TRAINA, NA, NA, NA);
-	nodes[64][47]->SetNode(COL_GREY, NA, NA, NA, NA, TRAINA, NA, NA, NA);
+		grid.SetNode(67 + i, 45, COL_GREY, NA, NA, NA, TRAIN, NA, NA, NA, NA);
+	grid.SetNode(66, 45, COL_GREY, NA, NA, NA, TRAIN, NA, NA, NA, NA);
+	grid.SetNode(65, 46, COL_GREY, NA, NA, NA, NA, TRAINA, NA, NA, NA);
+	grid.SetNode(64, 47, COL_GREY, NA, NA, NA, NA, TRAINA, NA, NA, NA);
 	for (int i = 0; i < 4; i++)
-		nodes[64][51 - i]->SetNode(COL_GREY, NA, NA, NA, NA, NA, TRAIN, NA, NA);
-	nodes[64][52]->SetNode(COL_GREY, NA, NA, NA, NA, NA, TRAIN, NA, NA);
-	nodes[65][53]->SetNode(COL_GREY, TRAINA, NA, NA, NA, NA, NA, TRAINA, NA);
+		grid.SetNode(64, 51 - i, COL_GREY, NA, NA, NA, NA, NA, TRAIN, NA, NA);
+	grid.SetNode(64, 52, COL_GREY, NA, NA, NA, NA, NA, TRAIN, NA, NA);
+	grid.SetNode(65, 53, COL_GREY, TRAINA, NA, NA, NA, NA, NA, TRAINA, NA);
 
 	/* --- TRAIN STATIONS --- */
 
 	// Red - South Morang & Hurstbridge Line
-	nodes[85][55]->SetNode(COL_WHITE, WALKA, WALK, TRAINA, WALK, WALKA, WALK, TRAINA, WALK);			// Clifton Hill
-	nodes[102][73]->SetNode(COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// South Morang
-	nodes[123][67]->SetNode(COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// Hurstbridge
+	grid.SetNode(85, 55, COL_WHITE, WALKA, WALK, TRAINA, WALK, WALKA, WALK, TRAINA, WALK);			// Clifton Hill
+	grid.SetNode(102, 73, COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// South Morang
+	grid.SetNode(123, 67, COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// Hurstbridge
 
 	// Yellow - Sunbury, Craigieburn & Upfield Line
-	nodes[42][56]->SetNode(COL_WHITE, TRAINA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, WALK);			// Sunshine
-	nodes[40][64]->SetNode(COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN, WALKA, WALK);			// Watergardens
-	nodes[40][67]->SetNode(COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, TRAIN, WALKA, WALK);				// Sunbury
-	nodes[56][76]->SetNode(COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN, WALKA, WALK);			// Broadmeadows
-	nodes[56][80]->SetNode(COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, WALK);				// Craigieburn
-	nodes[69][76]->SetNode(COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, TRAIN, WALKA, WALK);				// Upfield
+	grid.SetNode(42, 56, COL_WHITE, TRAINA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, WALK);			// Sunshine
+	grid.SetNode(40, 64, COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN, WALKA, WALK);			// Watergardens
+	grid.SetNode(40, 67, COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, TRAIN, WALKA, WALK);				// Sunbury
+	grid.SetNode(56, 76, COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN, WALKA, WALK);			// Broadmeadows
+	grid.SetNode(56, 80, COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, WALK);				// Craigieburn
+	grid.SetNode(69, 76, COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, TRAIN, WALKA, WALK);				// Upfield
 
 	// Blue - Lilydale, Melbrave, Alamein & Glen Waverley Line
-	nodes[85][43]->SetNode(COL_WHITE, WALKA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN);			// Burnley
-	nodes[112][35]->SetNode(COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// Glen Waverley
-	nodes[92][49]->SetNode(COL_WHITE, WALKA, WALK, TRAINA, WALK, WALKA, WALK, TRAINA, WALK);			// Camberwell
-	nodes[104][42]->SetNode(COL_WHITE, TRAINA, WALK, WALKA, WALK, WALKA, WALK, WALKA, WALK);			// Alamein
-	nodes[117][61]->SetNode(COL_WHITE, WALKA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN);			// Ringwood
-	nodes[129][50]->SetNode(COL_WHITE, TRAINA, WALK, WALKA, WALK, WALKA, WALK, WALKA, WALK);			// Belgrave
-	nodes[129][61]->SetNode(COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// Lilydale
+	grid.SetNode(85, 43, COL_WHITE, WALKA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN);			// Burnley
+	grid.SetNode(112, 35, COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// Glen Waverley
+	grid.SetNode(92, 49, COL_WHITE, WALKA, WALK, TRAINA, WALK, WALKA, WALK, TRAINA, WALK);			// Camberwell
+	grid.SetNode(104, 42, COL_WHITE, TRAINA, WALK, WALKA, WALK, WALKA, WALK, WALKA, WALK);			// Alamein
+	grid.SetNode(117, 61, COL_WHITE, WALKA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN);			// Ringwood
+	grid.SetNode(129, 50, COL_WHITE, TRAINA, WALK, WALKA, WALK, WALKA, WALK, WALKA, WALK);			// Belgrave
+	grid.SetNode(129, 61, COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// Lilydale
 
 	// Cyan - Pakenham & Cranbourne Line
-	nodes[95][25]->SetNode(COL_WHITE, TRAINA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// Clayton
-	nodes[103][17]->SetNode(COL_WHITE, TRAINA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// Dandenong
-	nodes[104][13]->SetNode(COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, WALK, WALKA, WALK);			// Cranbourne
-	nodes[128][16]->SetNode(COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// Pakenham
+	grid.SetNode(95, 25, COL_WHITE, TRAINA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// Clayton
+	grid.SetNode(103, 17, COL_WHITE, TRAINA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// Dandenong
+	grid.SetNode(104, 13, COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, WALK, WALKA, WALK);			// Cranbourne
+	grid.SetNode(128, 16, COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// Pakenham
 
 	// Green - Frankston, Werribee & Williamstown Line
-	nodes[47][49]->SetNode(COL_WHITE, WALKA, WALK, TRAINA, WALK, WALKA, WALK, TRAINA, WALK);			// Newport
-	nodes[45][41]->SetNode(COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, WALK, WALKA, WALK);				// Williamstown
-	nodes[39][44]->SetNode(COL_WHITE, WALKA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN);			// Altona
-	nodes[34][47]->SetNode(COL_WHITE, TRAINA, WALK, WALKA, TRAIN, TRAINA, WALK, WALKA, WALK);			// Laverton
-	nodes[29][52]->SetNode(COL_WHITE, WALKA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);				// Werribee
-	nodes[100][10]->SetNode(COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// Frankston
+	grid.SetNode(47, 49, COL_WHITE, WALKA, WALK, TRAINA, WALK, WALKA, WALK, TRAINA, WALK);			// Newport
+	grid.SetNode(45, 41, COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, WALK, WALKA, WALK);				// Williamstown
+	grid.SetNode(39, 44, COL_WHITE, WALKA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN);			// Altona
+	grid.SetNode(34, 47, COL_WHITE, TRAINA, WALK, WALKA, TRAIN, TRAINA, WALK, WALKA, WALK);			// Laverton
+	grid.SetNode(29, 52, COL_WHITE, WALKA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);				// Werribee
+	grid.SetNode(100, 10, COL_WHITE, WALKA, WALK, WALKA, WALK, WALKA, WALK, WALKA, TRAIN);			// Frankston
 	
 	// Pink - Sandringham Line
-	nodes[76][23]->SetNode(COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, WALK, WALKA, WALK);				// Sandringham
+	grid.SetNode(76, 23, COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, WALK, WALKA, WALK);				// Sandringham
 	
 	// Grey - Multiple Lines
-	nodes[55][56]->SetNode(COL_WHITE, WALKA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN);			// Footscray
-	nodes[63][55]->SetNode(COL_WHITE, TRAINA, TRAIN, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// North Melbourne
-	nodes[76][44]->SetNode(COL_WHITE, TRAINA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// Richmond
-	nodes[78][42]->SetNode(COL_WHITE, TRAINA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// South Yarra
-	nodes[86][34]->SetNode(COL_WHITE, TRAINA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// Caulfield
+	grid.SetNode(55, 56, COL_WHITE, WALKA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, TRAIN);			// Footscray
+	grid.SetNode(63, 55, COL_WHITE, TRAINA, TRAIN, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// North Melbourne
+	grid.SetNode(76, 44, COL_WHITE, TRAINA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// Richmond
+	grid.SetNode(78, 42, COL_WHITE, TRAINA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// South Yarra
+	grid.SetNode(86, 34, COL_WHITE, TRAINA, WALK, WALKA, WALK, TRAINA, WALK, WALKA, WALK);			// Caulfield
 
 	// Grey - City Loop
-	nodes[68][54]->SetNode(COL_WHITE, WALKA, WALK, WALKA, NA, WALKA, WALK, WALKA, TRAIN);				// Flagstaff
-	nodes[71][54]->SetNode(COL_WHITE, WALKA, WALK, WALKA, NA, WALKA, WALK, WALKA, TRAIN);				// Melbourne Central
-	nodes[75][49]->SetNode(COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, NA, WALKA, WALK);				// Parliament
-	nodes[69][45]->SetNode(COL_WHITE, WALKA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, NA);				// Flinders Street
-	nodes[64][49]->SetNode(COL_WHITE, WALKA, NA, WALKA, WALK, WALKA, TRAIN, WALKA, WALK);				// Southern Cross
+	grid.SetNode(68, 54, COL_WHITE, WALKA, WALK, WALKA, NA, WALKA, WALK, WALKA, TRAIN);				// Flagstaff
+	grid.SetNode(71, 54, COL_WHITE, WALKA, WALK, WALKA, NA, WALKA, WALK, WALKA, TRAIN);				// Melbourne Central
+	grid.SetNode(75, 49, COL_WHITE, WALKA, TRAIN, WALKA, WALK, WALKA, NA, WALKA, WALK);				// Parliament
+	grid.SetNode(69, 45, COL_WHITE, WALKA, WALK, WALKA, TRAIN, WALKA, WALK, WALKA, NA);				// Flinders Street
+	grid.SetNode(64, 49, COL_WHITE, WALKA, NA, WALKA, WALK, WALKA, TRAIN, WALKA, WALK);				// Southern Cross
 
 	/* --- ADJACENT NODES --- */
 
@@ -274,36 +277,37 @@ Pathfinder::Pathfinder()
 	{
 		for (int x = 0; x < GRID_W; x++)
 		{
-			if (nodes[x][y]->colour != COL_BLACK)
+			int cell = grid.GetIndex(x, y);
+			if (grid.GetColour(cell) != COL_BLACK)
 				continue;
 
 			for (int n = 0; n < NEIGHBOUR_COUNT; n++)
 			{
-				GraphNode* neighbour = nodes[x][y]->neighbours[n];
-				if (neighbour == nullptr) continue;
+				int neighbour = grid.GetNeighbour(cell, n);
+				if (!grid.IsInside(neighbour)) continue;
 
 				// If this neighbour is a train line, set cost to NA
-				else if (neighbour->colour != COL_BLACK && neighbour->colour != COL_WHITE)
-					nodes[x][y]->costs[n] = NA;
+				else if (IsTrainLine(neighbour))
+					grid.SetCost(cell, n, NA);
 
 				// If a diagonal line through the train line is a free node, set that cost to NA
-				else if (neighbour->colour == COL_BLACK)
+				else if (grid.GetColour(neighbour) == COL_BLACK)
 				{
-					GraphNode* node1 = nullptr;
-					GraphNode* node2 = nullptr;
+					int node1 = -1;
+					int node2 = -1;
 					switch (n)
 					{
-					case 0:		node1 = nodes[x][y]->neighbours[1];		node2 = nodes[x][y]->neighbours[7];		break;
-					case 2:		node1 = nodes[x][y]->neighbours[1];		node2 = nodes[x][y]->neighbours[3];		break;
-					case 4:		node1 = nodes[x][y]->neighbours[3];		node2 = nodes[x][y]->neighbours[5];		break;
-					case 6:		node1 = nodes[x][y]->neighbours[5];		node2 = nodes[x][y]->neighbours[7];		break;
+					case 0:		node1 = grid.GetNeighbour(cell, 1);		node2 = grid.GetNeighbour(cell, 7);		break;
+					case 2:		node1 = grid.GetNeighbour(cell, 1);		node2 = grid.GetNeighbour(cell, 3);		break;
+					case 4:		node1 = grid.GetNeighbour(cell, 3);		node2 = grid.GetNeighbour(cell, 5);		break;
+					case 6:		node1 = grid.GetNeighbour(cell, 5);		node2 = grid.GetNeighbour(cell, 7);		break;
 					}
 
-					if (node1 == nullptr || node2 == nullptr)
+					if (node1 == -1 || !grid.IsInside(node1) || !grid.IsInside(node2))
 						continue;
 
-					if (node1->colour != COL_BLACK && node1->colour != COL_WHITE && node2->colour != COL_BLACK && node2->colour != COL_WHITE)
-						nodes[x][y]->costs[n] = NA;
+					if (IsTrainLine(node1) && IsTrainLine(node2))
+						grid.SetCost(cell, n, NA);
 				}
 			}
 		}
@@ -312,116 +316,535 @@ Pathfinder::Pathfinder()
 #pragma endregion PTV Train Network
 }
 
-// Delete all GraphNodes in the Pathfinder object
-Pathfinder::~Pathfinder()
-{
-	// Delete all GraphNodes and set their pointers to null
-	for (int y = 0; y < GRID_H; y++)
-	{
-		for (int x = 0; x < GRID_W; x++)
-		{
-			delete nodes[x][y];
-			nodes[x][y] = nullptr;
-		}
-	}
-}
-
 /* ---- PATHFINDING ALGORITHMS ---- */
 // Performs pathfinding between the two specified world positions using A* algorithm, returning true if a path was found, otherwise false
 bool Pathfinder::AStarPath(Vector2 start, Vector2 end, List<Vector2>& finalPath)
 {
-	/* --- INITIALIZATION --- */
-
-	// Get start and end Nodes and clear the path
-	GraphNode* nodeStart = GetNodeByPos(start);
-	GraphNode* nodeEnd = GetNodeByPos(end);
+	return AStarPath(start, end, finalPath, defaultContext);
+}
+// As above, but keeps all search state in the specified SearchContext so that other threads can query at the same time with their own
+bool Pathfinder::AStarPath(Vector2 start, Vector2 end, List<Vector2>& finalPath, SearchContext& context, SearchMode mode) const
+{
+	// Clear the path, and search between the start and end cells
 	finalPath.Clear();
+	if (!FindPath(GetNodeByPos(start), GetNodeByPos(end), context, mode))
+		return false;
+
+	// Path has been found, so add it
+	for (int current : context.path)
+		finalPath.Add(GetPosByNode(current));
+	return true;
+}
+// Writes the path stored in the specified SearchContext from start to end into the specified cell array, in the specified PathFormat
+// Writes no more than the specified capacity, and returns the number of cells the whole path needs (so a larger array can be given if it didn't fit)
+int Pathfinder::WritePath(const SearchContext& context, int* cells, int capacity, PathFormat format) const
+{
+	int count = 0;
+	for (int i = (int)context.path.size() - 1; i != -1; i = GetNextPathIndex(context, i, format))
+	{
+		if (count < capacity)
+			cells[count] = context.path[i];
+		count++;
+	}
+	return count;
+}
+// As above, but writes the world position of each cell
+int Pathfinder::WritePath(const SearchContext& context, Vector2* positions, int capacity, PathFormat format) const
+{
+	int count = 0;
+	for (int i = (int)context.path.size() - 1; i != -1; i = GetNextPathIndex(context, i, format))
+	{
+		if (count < capacity)
+			positions[count] = GetPosByNode(context.path[i]);
+		count++;
+	}
+	return count;
+}
+// Searches between the two specified cells using the specified SearchMode, returning true if a path was found, otherwise false
+// When found, the path's cells are stored in the SearchContext
+bool Pathfinder::FindPath(int nodeStart, int nodeEnd, SearchContext& context, SearchMode mode) const
+{
+	if (StartSearch(nodeStart, nodeEnd, context, mode) == SearchStatus::Searching)
+		ContinueSearch(context, INT_MAX);
+	return context.status == SearchStatus::Found;
+}
+// Starts a search between the two specified cells using the specified SearchMode, to be run a little at a time with ContinueSearch
+// Returns the search's SearchStatus, which is only Searching if it needs continuing (the start and end alone can be enough to finish it)
+SearchStatus Pathfinder::StartSearch(int nodeStart, int nodeEnd, SearchContext& context, SearchMode mode) const
+{
+	assert((int)context.scoreG.size() == grid.GetCellCount() && "The SearchContext was created for a different size of map");
+	context.path.clear();
+	context.stats = SearchStats();
+
+	// Bidirectional searches need consistent estimates, which the octile estimate isn't across train lines, so need landmarks
+	if (mode == SearchMode::Bidirectional && !landmarks.IsBuilt())
+		mode = SearchMode::AStar;
+	context.mode = mode;
+	context.stats.mode = mode;
+	context.nodeStart = nodeStart;
+	context.nodeEnd = nodeEnd;
+	context.mapVersion = grid.GetVersion();
 
 	/* --- EARLY EXIT --- */
 
-	// Return false if immediately no path is possible
-	if (nodeStart == nullptr || nodeEnd == nullptr || nodeEnd->isBlocked)
-		return false;
+	// Return NoPath if immediately no path is possible
+	context.status = SearchStatus::NoPath;
+	if (nodeStart == -1 || nodeEnd == -1 || grid.IsBlocked(nodeEnd))
+		return context.status;
 
-	// Return true if path ends on itself
+	// Return Found if path ends on itself
 	if (nodeStart == nodeEnd)
 	{
-		finalPath.Add(nodeEnd->position);
-		return true;
+		context.path.push_back(nodeEnd);
+		context.stats.pathCells = 1;
+		context.status = SearchStatus::Found;
+		return context.status;
+	}
+
+	/* --- INITIALIZATION --- */
+
+	// Clear open list and start a new search
+	// Cells are only part of this search once stamped with its ID, so the closed list and stale scores don't need clearing
+	context.BeginSearch();
+	context.SetVisited(nodeStart);
+	context.scoreG[nodeStart] = 0;
+	context.prev[nodeStart] = -1;
+	context.listOpen.Push(nodeStart, 0);
+	context.stats.pushes++;
+
+	// Bidirectional searches also start from the end cell, in the reverse SearchContext, with both scored by the same potential
+	if (mode == SearchMode::Bidirectional)
+	{
+		SearchContext& reverse = context.GetReverse();
+		reverse.BeginSearch();
+		reverse.SetVisited(nodeEnd);
+		reverse.scoreG[nodeEnd] = 0;
+		reverse.prev[nodeEnd] = -1;
+		int estimate = GetEstimate(nodeStart, nodeEnd, mode);
+		reverse.listOpen.Push(nodeEnd, estimate);
+		context.listOpen.UpdateScore(nodeStart, estimate);
+		context.stats.pushes++;
+		context.meeting = -1;
+		context.meetingCost = INT_MAX;
 	}
 
-	/* --- FULL PATHFINDING ALGORITHM --- */
+	context.status = SearchStatus::Searching;
+	return context.status;
+}
+// Continues the search started with StartSearch, expanding no more than the specified number of cells, and returns its SearchStatus
+// When found, the path's cells are stored in the SearchContext
+SearchStatus Pathfinder::ContinueSearch(SearchContext& context, int maxExpansions) const
+{
+	if (context.status != SearchStatus::Searching)
+		return context.status;
+
+	// Scores from before the map changed may be wrong, so start again if it has changed since the search started
+	if (context.mapVersion != grid.GetVersion() && StartSearch(context.nodeStart, context.nodeEnd, context, context.mode) != SearchStatus::Searching)
+		return context.status;
+
+	/* --- SEARCH --- */
 
-	// Clear open and closed lists
-	listOpen.Clear();
-	memset(listClosed, 0, sizeof(bool) * (GRID_W * GRID_H));
+	auto startTime = std::chrono::steady_clock::now();
+	SearchStatus status = SearchStatus::NoPath;
+	switch (context.mode)
+	{
+	case SearchMode::AStar:			status = SearchAStar(context, maxExpansions);			break;
+	case SearchMode::JumpPoint:		status = SearchJumpPoint(context, maxExpansions);		break;
+	case SearchMode::Landmark:		status = SearchAStar(context, maxExpansions);			break;
+	case SearchMode::Bidirectional:	status = SearchBidirectional(context, maxExpansions);	break;
+	case SearchMode::AnyAngle:		status = SearchAnyAngle(context, maxExpansions);		break;
+	}
+	if (status == SearchStatus::Found)
+		StorePath(context);
+
+	context.status = status;
+	context.stats.microseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+	return status;
+}
+// Walks back from the end cell of the specified SearchContext's finished search to store its path
+void Pathfinder::StorePath(SearchContext& context) const
+{
+	// Fill in the cells skipped over by any jumps or any-angle moves
+	for (int current = context.nodeEnd; current != -1; current = context.prev[current])
+	{
+		context.path.push_back(current);
 
-	// Reset start node
-	nodeStart->scoreF = 0;
-	nodeStart->scoreG = 0;
-	nodeStart->scoreH = 0;
-	nodeStart->prev = nullptr;
-	listOpen.Push(nodeStart);
+		int previous = context.prev[current];
+		if (previous == -1)
+			continue;
+
+		// The skipped cells are those the line from the previous cell crosses, as that's the line the move was costed along
+		// They're found in order from the previous cell, so are reversed to match the rest of the path
+		int first = (int)context.path.size();
+		grid.WalkLine(previous, current, [&](int cell, int n)
+		{
+			int next = grid.GetNeighbour(cell, n);
+			if (next != current)
+				context.path.push_back(next);
+			return true;
+		});
+		std::reverse(context.path.begin() + first, context.path.end());
+	}
+
+	context.stats.pathCells = (int)context.path.size();
+	context.stats.pathCost = context.scoreG[context.nodeEnd];
+}
+// Performs A* from the start cell already in the open list towards the end cell, expanding no more than the specified number of cells
+// Returns the search's SearchStatus
+SearchStatus Pathfinder::SearchAStar(SearchContext& context, int maxExpansions) const
+{
+	NodeHeap& listOpen = context.listOpen;
+	std::vector<int>& scoreG = context.scoreG;
+	int nodeEnd = context.nodeEnd;
 
 	// Perform pathfinding using A* algorithm
-	while (listOpen.GetCount() > 0)
+	for (int expansions = 0; expansions < maxExpansions && listOpen.GetCount() > 0; expansions++)
 	{
-		// Remove current node from top of list and add to closed list
-		GraphNode* current = listOpen.Pop();
-		listClosed[current->indexX][current->indexY] = true;
+		// Remove current cell from top of list and add to closed list
+		int current = listOpen.Pop();
+		context.SetClosed(current);
+		context.stats.pops++;
 
-		// If we've just added end node to the closed list then path has been found
+		// If we've just added end cell to the closed list then path has been found
 		if (current == nodeEnd)
+			return SearchStatus::Found;
+		context.stats.expanded++;
+
+		// Process all neighbours
+		for (int n = 0; n < NEIGHBOUR_COUNT; n++)
 		{
-			finalPath.Add(current->position);
-			while (current->prev != nullptr)
+			// Get neighbour (cells outside the grid are always blocked)
+			int neighbour = grid.GetNeighbour(current, n);
+
+			// Sanity-checking
+			if (grid.IsBlocked(neighbour))
+				continue;
+			if (context.IsClosed(neighbour))
+				continue;
+
+			AddToOpen(current, neighbour, scoreG[current] + grid.GetCost(current, n), nodeEnd, context);
+		}
+	}
+
+	return (listOpen.GetCount() > 0) ? SearchStatus::Searching : SearchStatus::NoPath;
+}
+// As above, but performs Jump Point Search
+SearchStatus Pathfinder::SearchJumpPoint(SearchContext& context, int maxExpansions) const
+{
+	/*
+	Across cells that only use the standard costs every straight and
+	diagonal move costs the same, so many paths between two cells are
+	equally cheap. Rather than adding each neighbour to the open list, this
+	keeps moving in the direction of travel and only stops at cells where
+	the path might need to turn: the end cell, cells with their own costs
+	(train lines and stations), cells where one of those or a blocked cell
+	beside the path forces a turn, and diagonal cells where a straight jump
+	reaches one of those. Running into a blocked cell or the border finds
+	nothing, so jumps cross open ground in one go.
+	Each cell stopped at continues in its direction of travel and towards
+	its forced neighbours. Cells with their own costs have all of their
+	neighbours processed exactly as in A*.
+	*/
+	NodeHeap& listOpen = context.listOpen;
+	std::vector<int>& scoreG = context.scoreG;
+	std::vector<int>& prev = context.prev;
+	int nodeEnd = context.nodeEnd;
+
+	for (int expansions = 0; expansions < maxExpansions && listOpen.GetCount() > 0; expansions++)
+	{
+		// Remove current cell from top of list and add to closed list
+		int current = listOpen.Pop();
+		context.SetClosed(current);
+		context.stats.pops++;
+
+		// If we've just added end cell to the closed list then path has been found
+		if (current == nodeEnd)
+			return SearchStatus::Found;
+		context.stats.expanded++;
+
+		// Cells with their own costs, the start, and cells reached from a cell with its own costs (which may have been too costly
+		// to move to the neighbours directly), process all neighbours as in A*, jumping towards each where the standard costs apply
+		if (!grid.IsStandard(current) || prev[current] == -1 || !grid.IsStandard(prev[current]))
+		{
+			bool isStandard = grid.IsStandard(current);
+			for (int n = 0; n < NEIGHBOUR_COUNT; n++)
 			{
-				current = current->prev;
-				finalPath.Add(current->position);
+				int steps = 1;
+				int neighbour = isStandard ? Jump(current, n, nodeEnd, steps) : grid.GetNeighbour(current, n);
+				if (neighbour == -1 || grid.IsBlocked(neighbour) || context.IsClosed(neighbour))
+					continue;
+
+				AddToOpen(current, neighbour, scoreG[current] + (steps * grid.GetCost(current, n)), nodeEnd, context);
 			}
-			return true;
+			continue;
 		}
 
-		// Process all neighbours
+		// Otherwise continue in the direction of travel, its two straight parts if diagonal (even directions are diagonal),
+		// and towards any neighbours a cell beside this one forces the path to turn to
+		int direction = GetDirection(prev[current], current);
+		unsigned int directions = (1u << direction) | grid.GetForcedNeighbours(current, direction);
+		if (direction % 2 == 0)
+			directions |= (1u << ((direction + 7) % NEIGHBOUR_COUNT)) | (1u << ((direction + 1) % NEIGHBOUR_COUNT));
 		for (int n = 0; n < NEIGHBOUR_COUNT; n++)
 		{
-			// Get neighbour
-			GraphNode* neighbour = current->neighbours[n];
+			if ((directions & (1u << n)) == 0)
+				continue;
 
-			// Sanity-checking
-			if (neighbour == nullptr || neighbour->isBlocked)
+			int steps = 0;
+			int jumpPoint = Jump(current, n, nodeEnd, steps);
+			if (jumpPoint == -1 || context.IsClosed(jumpPoint))
 				continue;
-			if (listClosed[neighbour->indexX][neighbour->indexY])
+
+			// Every step of a jump costs the same, as it only crosses cells using the standard costs
+			AddToOpen(current, jumpPoint, scoreG[current] + (steps * grid.GetCost(current, n)), nodeEnd, context);
+		}
+	}
+
+	return (listOpen.GetCount() > 0) ? SearchStatus::Searching : SearchStatus::NoPath;
+}
+// As above, but performs Theta*
+SearchStatus Pathfinder::SearchAnyAngle(SearchContext& context, int maxExpansions) const
+{
+	/*
+	This is A*, except that before linking a neighbour to the current
+	cell, it checks whether the current cell's own previous cell has a
+	straight line to the neighbour (see PathGrid::GetLineCost) that crosses
+	no blocked cells and costs no more than going through the current cell.
+	If so, the neighbour links straight to that earlier cell instead, so
+	paths are made of long lines at any angle rather than 8-way steps, and
+	only the ends of each line need steering towards.
+	Lines are costed cell by cell, so they never cut across a train line
+	or the expensive cells around it unless that's no more costly.
+	*/
+	NodeHeap& listOpen = context.listOpen;
+	std::vector<int>& scoreG = context.scoreG;
+	std::vector<int>& prev = context.prev;
+	int nodeEnd = context.nodeEnd;
+
+	for (int expansions = 0; expansions < maxExpansions && listOpen.GetCount() > 0; expansions++)
+	{
+		// Remove current cell from top of list and add to closed list
+		int current = listOpen.Pop();
+		context.SetClosed(current);
+		context.stats.pops++;
+
+		// If we've just added end cell to the closed list then path has been found
+		if (current == nodeEnd)
+			return SearchStatus::Found;
+		context.stats.expanded++;
+
+		int parent = prev[current];
+		for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+		{
+			int neighbour = grid.GetNeighbour(current, n);
+			if (grid.IsBlocked(neighbour) || context.IsClosed(neighbour))
 				continue;
 
-			// Check if in open list
-			int listPos = listOpen.Find(neighbour);
-			if (listPos != -1)
+			// Link to the previous cell if it has a clear line that costs no more, otherwise to the current cell as in A*
+			int newG = scoreG[current] + grid.GetCost(current, n);
+			int lineCost = (parent == -1) ? -1 : grid.GetLineCost(parent, neighbour, newG - scoreG[parent]);
+			if (lineCost != -1)
+				AddToOpen(parent, neighbour, scoreG[parent] + lineCost, nodeEnd, context);
+			else
+				AddToOpen(current, neighbour, newG, nodeEnd, context);
+		}
+	}
+
+	return (listOpen.GetCount() > 0) ? SearchStatus::Searching : SearchStatus::NoPath;
+}
+// As above, but performs A* from both the start and end cells already in the open lists at once
+// When found, the prev of every cell along the path is set, as if it had been found by searching forwards alone
+SearchStatus Pathfinder::SearchBidirectional(SearchContext& context, int maxExpansions) const
+{
+	/*
+	The forward half searches from the start using the SearchContext, and
+	the backward half searches from the end along reversed edges (so
+	one-way costs like the City Loop's are still followed the right way)
+	using the SearchContext's reverse.
+	Both halves use the same potential, halfway between the estimate to the
+	end and the estimate back to the start. As the landmark estimates are
+	consistent (StartSearch falls back to A* without them), an edge then
+	looks equally cheap from either side, so either half can be expanded
+	next, and the best meeting found so far is final once the two tops add
+	up to at least its cost. Scores are doubled, so the halving never rounds.
+	The half with fewer open cells is expanded, which keeps both halves
+	about the same size rather than letting one run ahead.
+	*/
+	SearchContext& forward = context;
+	SearchContext& reverse = context.GetReverse();
+	int nodeStart = context.nodeStart;
+	int nodeEnd = context.nodeEnd;
+
+	bool isFinished = false;
+	for (int expansions = 0; expansions < maxExpansions; expansions++)
+	{
+		// Stop once either half runs out of cells, or no unexpanded cell could lead to a cheaper meeting
+		isFinished = forward.listOpen.GetCount() == 0 || reverse.listOpen.GetCount() == 0;
+		if (!isFinished && context.meeting != -1)
+			isFinished = (long long)forward.listOpen.GetTopScore() + reverse.listOpen.GetTopScore() >= 2LL * context.meetingCost;
+		if (isFinished)
+			break;
+
+		// Expand the half with fewer open cells, so neither half grows much further than the other
+		bool isForward = forward.listOpen.GetCount() <= reverse.listOpen.GetCount();
+		SearchContext& side = isForward ? forward : reverse;
+		SearchContext& other = isForward ? reverse : forward;
+		int current = side.listOpen.Pop();
+		side.SetClosed(current);
+		forward.stats.pops++;
+
+		// The other half has already found the best way on from cells it has closed, so there's no need to expand them again
+		if (other.IsClosed(current))
+			continue;
+		forward.stats.expanded++;
+
+		for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+		{
+			int neighbour = grid.GetNeighbour(current, n);
+			if (grid.IsBlocked(neighbour) || side.IsClosed(neighbour))
+				continue;
+
+			// Backwards, the edge runs from the neighbour to the current cell
+			int cost = isForward ? grid.GetCost(current, n) : grid.GetCost(neighbour, (n + 4) % NEIGHBOUR_COUNT);
+			int newG = side.scoreG[current] + cost;
+
+			// Skip cells that can't lead to a cheaper meeting, judged by the estimate towards the other half's own end
+			int toEnd = GetEstimate(neighbour, nodeEnd, forward.mode);
+			int fromStart = GetEstimate(nodeStart, neighbour, forward.mode);
+			if (newG + (isForward ? toEnd : fromStart) >= context.meetingCost)
+				continue;
+
+			// Score by the shared potential, doubled
+			// A path through the cell also has to reach the other half's open list, so it can't cost less than half the two scores
+			int potential = isForward ? (toEnd - fromStart) : (fromStart - toEnd);
+			int score = (2 * newG) + potential;
+			if (context.meeting != -1 && (long long)score + other.listOpen.GetTopScore() >= 2LL * context.meetingCost)
+				continue;
+			if (!side.IsVisited(neighbour))
 			{
-				// Check if we found a cheaper path
-				int newG = current->scoreG + current->costs[n];
-				if (newG < neighbour->scoreG)
-				{
-					// Found a cheaper path, store new values and re-order Heap
-					neighbour->scoreG = newG;
-					neighbour->scoreF = neighbour->scoreG + neighbour->scoreH;
-					neighbour->prev = current;
-					listOpen.SiftUp(listPos);
-				}
+				side.SetVisited(neighbour);
+				side.scoreG[neighbour] = newG;
+				side.prev[neighbour] = current;
+				side.listOpen.Push(neighbour, score);
+				forward.stats.pushes++;
+			}
+			else if (newG < side.scoreG[neighbour])
+			{
+				side.scoreG[neighbour] = newG;
+				side.prev[neighbour] = current;
+				side.listOpen.DecreaseScore(neighbour, score);
+				forward.stats.decreases++;
 			}
 			else
+				continue;
+
+			// Remember the cheapest cell both halves have reached
+			if (other.IsVisited(neighbour) && newG + other.scoreG[neighbour] < context.meetingCost)
 			{
-				// Calculate costs and add to open list
-				neighbour->scoreG = current->scoreG + current->costs[n];
-				neighbour->scoreH = GetHeuristic(neighbour, nodeEnd);
-				neighbour->scoreF = neighbour->scoreG + neighbour->scoreH;
-				neighbour->prev = current;
-				listOpen.Push(neighbour);
+				context.meetingCost = newG + other.scoreG[neighbour];
+				context.meeting = neighbour;
 			}
 		}
 	}
 
-	return false;
+	if (!isFinished)
+		return SearchStatus::Searching;
+
+	// Searches may rely on the cells either half scored (such as PathCache), so include the backward half's
+	forward.firstVisited = std::min(forward.firstVisited, reverse.firstVisited);
+	forward.lastVisited = std::max(forward.lastVisited, reverse.lastVisited);
+	if (context.meeting == -1)
+		return SearchStatus::NoPath;
+
+	// Join the backward half's path onto the forward half's, so the path can be walked back from the end as usual
+	for (int current = context.meeting; current != nodeEnd; current = reverse.prev[current])
+		forward.prev[reverse.prev[current]] = current;
+	forward.scoreG[nodeEnd] = context.meetingCost;
+	return SearchStatus::Found;
+}
+// Moves from the specified cell in the specified direction until reaching a cell where the path might turn
+// Returns that cell and stores the number of steps taken, or returns -1 if a blocked cell is reached first
+int Pathfinder::Jump(int node, int direction, int nodeEnd, int& steps) const
+{
+	// Straight jumps are looked up, as the grid keeps how far the next jump point is in each straight direction
+	if (direction % 2 != 0)
+		return grid.JumpStraight(node, direction, nodeEnd, steps);
+
+	steps = 0;
+	while (true)
+	{
+		node = grid.GetNeighbour(node, direction);
+		steps++;
+
+		// Stop at the end cell, or a cell where the path might turn (see PathGrid::IsJumpPoint)
+		if (grid.IsBlocked(node))
+			return -1;
+		if (node == nodeEnd || grid.IsJumpPoint(node, direction))
+			return node;
+
+		// Also stop if either straight part of the direction reaches one of those cells
+		int straightSteps = 0;
+		if (grid.JumpStraight(node, (direction + 7) % NEIGHBOUR_COUNT, nodeEnd, straightSteps) != -1 ||
+			grid.JumpStraight(node, (direction + 1) % NEIGHBOUR_COUNT, nodeEnd, straightSteps) != -1)
+			return node;
+	}
+}
+// Adds the specified cell to the open list with the specified cost, or updates it if this is a cheaper path to it
+void Pathfinder::AddToOpen(int current, int neighbour, int newG, int nodeEnd, SearchContext& context) const
+{
+	// Check if in open list (every cell scored this search is open until closed)
+	if (context.IsVisited(neighbour))
+	{
+		// Check if we found a cheaper path
+		if (newG < context.scoreG[neighbour])
+		{
+			// Found a cheaper path, store new values and re-order Heap
+			context.scoreG[neighbour] = newG;
+			context.prev[neighbour] = current;
+			context.listOpen.DecreaseScore(neighbour, newG + GetEstimate(neighbour, nodeEnd, context.mode));
+			context.stats.decreases++;
+		}
+	}
+	else
+	{
+		// Calculate costs and add to open list
+		context.SetVisited(neighbour);
+		context.scoreG[neighbour] = newG;
+		context.prev[neighbour] = current;
+		context.listOpen.Push(neighbour, newG + GetEstimate(neighbour, nodeEnd, context.mode));
+		context.stats.pushes++;
+	}
+}
+
+// Returns the index in the SearchContext's path of the next cell to write after the specified index in the specified PathFormat, or -1 after the last
+// The path is stored from the end back to the start, so indices count down
+int Pathfinder::GetNextPathIndex(const SearchContext& context, int index, PathFormat format) const
+{
+	const std::vector<int>& path = context.path;
+	if (index <= 0)
+		return -1;
+	if (format == PathFormat::Cells)
+		return index - 1;
+
+	// Move along the path, counting its cost, and stop at each cell where the direction changes (always including the end)
+	int best = -1;
+	int cost = 0;
+	for (int next = index - 1; next >= 0; next--)
+	{
+		int direction = GetDirection(path[next + 1], path[next]);
+		cost += grid.GetCost(path[next + 1], direction);
+		if (next > 0 && GetDirection(path[next], path[next - 1]) == direction)
+			continue;
+		if (format == PathFormat::TurningPoints)
+			return next;
+
+		// When smoothing, keep going while a straight line reaches this turning point for no more than the path costs
+		// (the first is always reached, as the path runs straight to it)
+		if (best != -1 && grid.GetLineCost(path[index], path[next], cost) == -1)
+			break;
+		best = next;
+	}
+	return best;
 }
 
 /* ---- DRAW FUNCTIONS ---- */
@@ -431,34 +854,36 @@ void Pathfinder::Draw(aie::Renderer2D* renderer)
 	// Code is here if needed for debugging, but is not intended for use
 
 	/*renderer->SetRenderColour(COL_LINE);
-	for (int y = 0; y < GRID_H; y++)
+	for (int y = 0; y < grid.GetHeight(); y++)
 	{
-		for (int x = 0; x < GRID_W; x++)
+		for (int x = 0; x < grid.GetWidth(); x++)
 		{
-			GraphNode* node = nodes[x][y];
+			int node = grid.GetIndex(x, y);
+			Vector2 nodePos = GetPosByNode(node);
 			for (int n = 0; n < NEIGHBOUR_COUNT; n++)
 			{
-				GraphNode* neighbour = node->neighbours[n];
-				if (neighbour != nullptr)
-					renderer->DrawLine(node->position.x, node->position.y, neighbour->position.x, neighbour->position.y);
+				int neighbour = grid.GetNeighbour(node, n);
+				Vector2 neighbourPos = GetPosByNode(neighbour);
+				if (grid.IsInside(neighbour))
+					renderer->DrawLine(nodePos.x, nodePos.y, neighbourPos.x, neighbourPos.y);
 			}
 		}
 	}*/
 
 	// Draw Nodes
-	for (int y = 0; y < GRID_H; y++)
+	for (int y = 0; y < grid.GetHeight(); y++)
 	{
-		for (int x = 0; x < GRID_W; x++)
+		for (int x = 0; x < grid.GetWidth(); x++)
 		{
-			// Get node and calculate draw parameters
-			GraphNode* node = nodes[x][y];
-			float drawX = node->position.x;
-			float drawY = node->position.y;
+			// Get cell and calculate draw parameters
+			int node = grid.GetIndex(x, y);
+			float drawX = (float)(POS_XOFFSET + (x * NODE_W));
+			float drawY = (float)(POS_YOFFSET + (y * NODE_H));
 			float drawW = (float)(NODE_W * 0.5);
 			float drawH = (float)(NODE_H * 0.5);
 
 			// Draw node
-			renderer->SetRenderColour(node->colour);
+			renderer->SetRenderColour(grid.GetColour(node));
 			renderer->DrawBox(drawX, drawY, drawW, drawH);
 		}
 	}
@@ -468,8 +893,8 @@ void Pathfinder::Draw(aie::Renderer2D* renderer)
 }
 
 /* ---- MISC. FUNCTIONS ---- */
-// Get the GraphNode at the specified world position
-GraphNode* Pathfinder::GetNodeByPos(Vector2 pos)
+// Get the cell at the specified world position, or -1 if outside the grid
+int Pathfinder::GetNodeByPos(Vector2 pos) const
 {
 	// Remove node offset from specified position
 	pos.x -= POS_XOFFSET;
@@ -479,50 +904,78 @@ GraphNode* Pathfinder::GetNodeByPos(Vector2 pos)
 	int x = (int)((pos.x / NODE_W) + 0.5f);
 	int y = (int)((pos.y / NODE_H) + 0.5f);
 
-	// Return null if position does not contain a GraphNode, otherwise return GraphNode
-	if (x < 0 || x >= GRID_W || y < 0 || y >= GRID_H)
-		return nullptr;
+	// Return -1 if position does not contain a cell, otherwise return the cell
+	if (x < 0 || x >= grid.GetWidth() || y < 0 || y >= grid.GetHeight())
+		return -1;
 	else
-		return nodes[x][y];
+		return grid.GetIndex(x, y);
 }
-// Get the world position at the specified GraphNode
-Vector2 Pathfinder::GetPosByNode(GraphNode* node)
+// Get the world position at the specified cell
+Vector2 Pathfinder::GetPosByNode(int node) const
 {
-	return Vector2(POS_XOFFSET + (NODE_W * node->indexX), POS_YOFFSET + (NODE_H * node->indexY));
+	return Vector2((float)(POS_XOFFSET + (NODE_W * grid.GetX(node))), (float)(POS_YOFFSET + (NODE_H * grid.GetY(node))));
 }
-// Get the GraphNode using the specified GraphNode position and neighbour index
-// [0][1][2]
-// [7][X][3]
-// [6][5][4]
-GraphNode* Pathfinder::GetNeighbour(int nodeX, int nodeY, int neighbourIndex)
+// Set whether the cell at the specified world position can be traversed, if inside the grid
+void Pathfinder::SetBlocked(Vector2 pos, bool isBlocked)
 {
-	// Calcuate neighbour position
-	int x = nodeX;
-	int y = nodeY;
-	switch (neighbourIndex)
-	{
-	case 0:		x--;	y++;	break;
-	case 1:				y++;	break;
-	case 2:		x++;	y++;	break;
-	case 3:		x++;			break;
-	case 4:		x++;	y--;	break;
-	case 5:				y--;	break;
-	case 6:		x--;	y--;	break;
-	case 7:		x--;			break;
-	}
+	int node = GetNodeByPos(pos);
+	if (node == -1)
+		return;
+	grid.SetBlocked(node, isBlocked);
+
+	// Landmark costs are still lower bounds when a cell is blocked, but not once one opens up a shorter route
+	if (!isBlocked)
+		landmarks.Clear();
+}
+// Get the counters describing the last search run by AStarPath without a SearchContext
+const SearchStats& Pathfinder::GetLastStats() const
+{
+	return defaultContext.stats;
+}
+// Chooses the specified number of landmarks and precomputes their costs, for use by SearchMode::Landmark
+// This must be called again after any cell is unblocked, otherwise Landmark searches fall back to AStar's heuristic
+void Pathfinder::BuildLandmarks(int count)
+{
+	landmarks.Build(grid, count);
+}
+// Returns true if the specified cell is part of a train line (coloured, but not a station)
+bool Pathfinder::IsTrainLine(int node) const
+{
+	unsigned int colour = grid.GetColour(node);
+	return colour != COL_BLACK && colour != COL_WHITE;
+}
+// Get the direction (neighbour index) of a move from the first specified cell towards the second, which must be in a straight or diagonal line
+int Pathfinder::GetDirection(int fromNode, int toNode) const
+{
+	int dX = grid.GetX(toNode) - grid.GetX(fromNode);
+	int dY = grid.GetY(toNode) - grid.GetY(fromNode);
+	int signX = (dX > 0) - (dX < 0);
+	int signY = (dY > 0) - (dY < 0);
 
-	// Return null if neighbour is invalid, otherwise return neighbour GraphNode
-	if (x < 0 || x >= GRID_W || y < 0 || y >= GRID_H)
-		return nullptr;
-	else
-		return nodes[x][y];
+	// [0][1][2]
+	// [7][X][3]
+	// [6][5][4]
+	const int directions[3][3] =
+	{
+		{ 6, 7, 0 },	// signX = -1, for signY = -1, 0, 1
+		{ 5, -1, 1 },	// signX = 0
+		{ 4, 3, 2 }		// signX = 1
+	};
+	return directions[signX + 1][signY + 1];
+}
+// Get an estimate of the cost between the specified cells for the specified SearchMode
+int Pathfinder::GetEstimate(int startNode, int endNode, SearchMode mode) const
+{
+	if ((mode == SearchMode::Landmark || mode == SearchMode::Bidirectional) && landmarks.IsBuilt())
+		return landmarks.GetHeuristic(startNode, endNode);
+	return GetHeuristic(startNode, endNode);
 }
-// Get an estimate of how many moves between the specified GraphNodes using a Diagonal Distance algorithm
-int Pathfinder::GetHeuristic(GraphNode* startNode, GraphNode* endNode)
+// Get an estimate of how many moves between the specified cells using a Diagonal Distance algorithm
+int Pathfinder::GetHeuristic(int startNode, int endNode) const
 {
-	int dX = abs(startNode->indexX - endNode->indexX);		// Calculate absolute offset on x-axis
-	int dY = abs(startNode->indexY - endNode->indexY);		// Calculate absolute offset on y-axis
-	int min = (dX > dY) ? dY : dX;							// Calculate the smaller of the two
+	int dX = abs(grid.GetX(startNode) - grid.GetX(endNode));	// Calculate absolute offset on x-axis
+	int dY = abs(grid.GetY(startNode) - grid.GetY(endNode));	// Calculate absolute offset on y-axis
+	int min = (dX > dY) ? dY : dX;								// Calculate the smaller of the two
 	
 	return (10 * (dX + dY)) + (-6 * min);
 }
\ No newline at end of file
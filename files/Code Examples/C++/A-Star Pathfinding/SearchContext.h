@@ -0,0 +1,155 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include "NodeHeap.h"
+
+// The algorithm used to search for a path
+enum class SearchMode
+{
+	AStar,			// Expands every neighbour of each cell
+	JumpPoint,		// Jumps across uniform regions, only expanding cells where the path could turn (falls back to A* elsewhere)
+	Landmark,		// A* guided by the Pathfinder's LandmarkTable, which finds optimal paths along the train lines (uses AStar's heuristic until built)
+	Bidirectional,	// A* from both ends at once, meeting in the middle (uses Landmark's heuristic, and runs as AStar if landmarks aren't built, see SearchStats::mode)
+					// On the benchmark queries it expands 23% fewer cells than Landmark with 8 landmarks (153.7k vs 199.5k) and 16% fewer with 16 (105.2k vs 125.5k),
+					// but 27% more on a map of random walls (213.6k vs 167.6k), so it's only worth choosing over Landmark on open maps
+	AnyAngle		// Theta*, which lets a cell link straight back to any earlier cell it has a clear, no more costly line to
+};
+
+// How Pathfinder::WritePath writes out a path found
+enum class PathFormat
+{
+	Cells,			// Every cell along the path
+	TurningPoints,	// Only the start, the end and the cells where the path changes direction
+	Smoothed		// The turning points left after cutting straight past any that a line can skip without costing more
+};
+
+// The progress of a search run a little at a time with Pathfinder::StartSearch and ContinueSearch
+enum class SearchStatus
+{
+	Searching,		// The search has more cells to expand
+	Found,			// A path was found, and is stored in the SearchContext
+	NoPath,			// No path connects the start and end, or either is outside the grid
+	Cancelled		// The search was stopped before it finished (see PathQuery::Cancel)
+};
+
+// Counters describing the work done by the last search run with a SearchContext (both halves, for bidirectional searches)
+struct SearchStats
+{
+	SearchMode mode = SearchMode::AStar;	// The SearchMode actually run, which is AStar when Bidirectional was asked for without landmarks built
+	int expanded = 0;				// Cells whose neighbours were processed
+	int pushes = 0;					// Cells added to an open list
+	int pops = 0;					// Cells removed from an open list
+	int decreases = 0;				// Cells re-ordered in an open list after a cheaper path to them was found
+	int pathCells = 0;				// The number of cells in the path found, or 0 if there was none
+	int pathCost = 0;				// The total cost of the path found
+	double microseconds = 0.0;		// The wall time the search took, including storing the path (summed across every step of a time-sliced search)
+};
+
+/* ------------------------------
+SEARCHCONTEXT STRUCT
+
+The SearchContext holds all of the state a single path query writes to:
+the open list, per-cell scores and the search stamps.
+The PathGrid is only read while searching, so any number of threads can
+query the same Pathfinder at once as long as each uses its own
+SearchContext. A SearchContext is reused between queries, and only the
+cells a query visits are touched.
+When a path is found, its cells are stored in the path array, and
+counters describing the search are stored in stats.
+Bidirectional searches keep their backward half in a second
+SearchContext, which is only created the first time one is run.
+As everything a search needs is kept here, a search can also be stopped
+part way and continued later (see Pathfinder::ContinueSearch).
+-------------------------------*/
+
+struct SearchContext
+{
+	/* ---- CONSTRUCTORS & DESTRUCTORS ---- */
+	// Initializes the SearchContext for a grid with the specified number of cells
+	SearchContext(int cellCount) : listOpen(cellCount)
+	{
+		mode = SearchMode::AStar;
+		status = SearchStatus::NoPath;
+		nodeStart = -1;
+		nodeEnd = -1;
+		mapVersion = 0;
+		meeting = -1;
+		meetingCost = INT_MAX;
+		searchId = 0;
+		firstVisited = INT_MAX;
+		lastVisited = -1;
+		path.reserve(cellCount);
+		scoreG.assign(cellCount, 0);
+		prev.assign(cellCount, -1);
+		visitedId.assign(cellCount, 0);
+		closedId.assign(cellCount, 0);
+	}
+
+	/* ---- SEARCH FUNCTIONS ---- */
+	// Starts a new search by clearing the open list and advancing the search ID, only resetting cell stamps when the ID wraps around
+	void BeginSearch()
+	{
+		listOpen.Clear();
+		firstVisited = INT_MAX;
+		lastVisited = -1;
+
+		searchId++;
+		if (searchId != 0)
+			return;
+
+		// Stamps from before the wrap could match again, so clear them and skip the ID of 0
+		std::fill(visitedId.begin(), visitedId.end(), 0);
+		std::fill(closedId.begin(), closedId.end(), 0);
+		searchId = 1;
+	}
+	void SetVisited(int cell) // Stamps the specified cell as scored during the current search
+	{
+		visitedId[cell] = searchId;
+		firstVisited = std::min(firstVisited, cell);
+		lastVisited = std::max(lastVisited, cell);
+	}
+	void SetClosed(int cell) // Stamps the specified cell as closed during the current search
+	{
+		closedId[cell] = searchId;
+	}
+	// Returns true if the specified cell has been scored during the current search
+	bool IsVisited(int cell) const
+	{
+		return visitedId[cell] == searchId;
+	}
+	// Returns true if the specified cell has been closed during the current search
+	bool IsClosed(int cell) const
+	{
+		return closedId[cell] == searchId;
+	}
+
+	// Returns the SearchContext holding the backward half of a bidirectional search, creating it the first time it's needed
+	SearchContext& GetReverse()
+	{
+		if (reverse == nullptr)
+			reverse.reset(new SearchContext((int)scoreG.size()));
+		return *reverse;
+	}
+
+	/* ---- VARIABLES ---- */
+	NodeHeap listOpen;						// The open list, ordered by scoreF
+	std::vector<int> path;					// The cells of the last path found, ordered from the end back to the start
+	SearchMode mode;						// The SearchMode of the current search
+	SearchStatus status;					// The progress of the current search
+	SearchStats stats;						// Counters describing the last search
+	int nodeStart;							// The start cell of the current search
+	int nodeEnd;							// The end cell of the current search
+	unsigned int mapVersion;				// The grid's version when the current search started
+	int meeting;							// The cheapest cell both halves of a bidirectional search have reached so far, or -1
+	int meetingCost;						// The cost of the path through the meeting cell
+	unsigned int searchId;					// The ID of the current search, used to stamp cells
+	std::vector<int> scoreG;				// Cost of the best path found to each cell
+	std::vector<int> prev;					// The previous cell in the path to each cell (when found)
+	std::vector<unsigned int> visitedId;	// The last search that scored each cell
+	std::vector<unsigned int> closedId;		// The last search that closed each cell
+	int firstVisited;						// The lowest cell index scored during the current search
+	int lastVisited;						// The highest cell index scored during the current search
+	std::unique_ptr<SearchContext> reverse;	// The backward half of bidirectional searches, where prev is the next cell towards the end
+};